@@ -0,0 +1,216 @@
+// 主机端微基准：测量各个纯逻辑热点每次调用的耗时，用于比较改动前后的开销
+// 只输出结果不做断言；开启 sanitizer 时数字偏大，比较性能请用 -DHOST_TEST_SANITIZE=OFF 配置
+#include "output_gain.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "message_dispatcher.h"
+#include "device_state_machine.h"
+#include "led_animation.h"
+#include "audio_levels.h"
+#include "mono_page_frame.h"
+#include "glyph_cache.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+// 60 ms 16 kHz 单声道，与 Opus 帧长一致
+#define FRAME_SAMPLES 960
+
+// 防止编译器把被测调用优化掉
+static volatile int64_t sink = 0;
+
+// 统计堆分配次数：设备上每次 malloc 都要加锁并可能加剧内部 RAM 碎片，比主机上贵得多
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// 16x16 的 4bpp 字形，按 LVGL 的方式展开成 A8
+#define GLYPH_SIZE 16
+static uint8_t glyph_source[GLYPH_SIZE * GLYPH_SIZE / 2];
+
+static bool GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next) {
+    dsc->gid.index = letter;
+    dsc->box_w = GLYPH_SIZE;
+    dsc->box_h = GLYPH_SIZE;
+    dsc->format = LV_FONT_GLYPH_FORMAT_A8;
+    return true;
+}
+
+static const void* GetGlyphBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    for (int y = 0; y < GLYPH_SIZE; y++) {
+        for (int x = 0; x < GLYPH_SIZE; x++) {
+            uint8_t packed = glyph_source[(y * GLYPH_SIZE + x) / 2];
+            uint8_t value = (x & 1) ? (packed & 0x0f) : (packed >> 4);
+            draw_buf->data[y * draw_buf->header.stride + x] = value * 17;
+        }
+    }
+    return draw_buf;
+}
+
+// 按 LVGL 绘制文字的顺序取描述和位图
+static void DrawGlyph(const lv_font_t* font, uint32_t letter, lv_draw_buf_t* draw_buf) {
+    lv_font_glyph_dsc_t dsc = {};
+    font->get_glyph_dsc(font, &dsc, letter, 0);
+    dsc.resolved_font = font;
+    sink += font->get_glyph_bitmap(&dsc, draw_buf) != nullptr;
+}
+
+static void Run(const char* name, int iterations, const std::function<void()>& body) {
+    body();
+    size_t start_allocations = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        body();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    printf("%-28s %10.1f ns/op %6.1f allocs/op  (%d ops)\n", name, double(elapsed.count()) / iterations,
+        double(allocations - start_allocations) / iterations, iterations);
+}
+
+int main() {
+    std::vector<int16_t> pcm(FRAME_SAMPLES);
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        pcm[i] = static_cast<int16_t>(16000 * sin(2 * M_PI * 440 * i / 16000.0));
+    }
+
+    Run("VolumeToFactor", 200000, []() {
+        for (int volume = 0; volume <= 100; volume += 10) {
+            sink += VolumeToFactor(volume);
+        }
+    });
+
+    std::vector<int16_t> output(FRAME_SAMPLES);
+    int32_t step = GainRampStep(16000, 1);
+    Run("ApplyGainRamp frame", 5000, [&]() {
+        memcpy(output.data(), pcm.data(), FRAME_SAMPLES * sizeof(int16_t));
+        sink += ApplyGainRamp(output.data(), output.size(), 0, OUTPUT_GAIN_UNITY, step);
+    });
+
+    const char tts[] = "{\"type\":\"tts\",\"state\":\"sentence_start\",\"session_id\":\"a1b2c3d4\","
+        "\"text\":\"\\u4eca\\u5929\\u5929\\u6c14\\u600e\\u4e48\\u6837\"}";
+    char json[sizeof(tts)];
+    static const char* const names[] = { "type", "state", "text", "emotion", "session_id" };
+    const char* values[5];
+    Run("JsonReader tts message", 50000, [&]() {
+        memcpy(json, tts, sizeof(tts));
+        sink += JsonReader::ParseStringFields(json, sizeof(tts) - 1, names, values, 5);
+    });
+
+    // 与 Protocol::SendWakeWordDetected 相同的消息，两种写法都生成交给 SendText 的 std::string
+    std::string session_id = "a1b2c3d4";
+    std::string wake_word = "你好小智";
+    Run("std::string listen message", 100000, [&]() {
+        std::string json = "{\"session_id\":\"" + session_id +
+                          "\",\"type\":\"listen\",\"state\":\"detect\",\"text\":\"" + wake_word + "\"}";
+        sink += json.size();
+    });
+    Run("JsonWriter listen message", 100000, [&]() {
+        StaticJsonWriter<192> writer;
+        writer.BeginObject()
+            .AddString("session_id", session_id)
+            .AddString("type", "listen")
+            .AddString("state", "detect")
+            .AddString("text", wake_word)
+            .EndObject();
+        sink += writer.ToString().size();
+    });
+
+    MessageDispatcher dispatcher;
+    int handled = 0;
+    const char* states[] = { "start", "stop", "sentence_start" };
+    for (auto state : states) {
+        dispatcher.Register("tts", state, [&handled](const IncomingMessage&) { handled++; });
+    }
+    dispatcher.Register("stt", [&handled](const IncomingMessage&) { handled++; });
+    dispatcher.Register("llm", [&handled](const IncomingMessage&) { handled++; });
+    IncomingMessage message;
+    message.type = "tts";
+    message.state = "sentence_start";
+    Run("MessageDispatcher dispatch", 200000, [&]() {
+        sink += dispatcher.Dispatch(message);
+    });
+
+    DeviceStateMachine machine;
+    machine.HandleEvent(kDeviceEventStart);
+    machine.HandleEvent(kDeviceEventReady);
+    Run("DeviceStateMachine turn", 100000, [&]() {
+        sink += machine.HandleEvent(kDeviceEventListen);
+        sink += machine.HandleEvent(kDeviceEventSpeak);
+        sink += machine.HandleEvent(kDeviceEventStop);
+    });
+
+    LedAnimationSpec scroll;
+    scroll.keyframes = { { 0, { 0, 0, 4 } }, { 500, { 0, 0, 16 } }, { 1000, { 0, 0, 4 } } };
+    scroll.frame_interval_ms = 20;
+    scroll.pixel_phase_ms = 80;
+    Run("LedAnimation::Build 12px 1s", 2000, [&]() {
+        sink += LedAnimation::Build(scroll, 12).frame_count();
+    });
+
+    AudioLevelAnalyzer analyzer;
+    Run("AudioLevelAnalyzer frame", 5000, [&]() {
+        sink += analyzer.Analyze(pcm.data(), pcm.size(), 1, 16000).rms;
+    });
+
+    // 状态栏图标闪烁：128x16 的区域内容交替变化
+    MonoPageFrame frame(128, 64);
+    std::vector<uint8_t> bits(16 * 16);
+    int toggle = 0;
+    Run("MonoPageFrame fold 128x16", 10000, [&]() {
+        memset(bits.data(), (toggle++ & 1) ? 0xff : 0xf0, bits.size());
+        frame.Fold(0, 0, 127, 15, bits.data(), 16);
+        int x1, x2;
+        for (int i = 0; i < frame.pages(); i++) {
+            sink += frame.TakeDirtyRange(i, x1, x2);
+        }
+    });
+
+    for (size_t i = 0; i < sizeof(glyph_source); i++) {
+        glyph_source[i] = static_cast<uint8_t>(i * 37);
+    }
+    lv_font_t base_font = {};
+    base_font.get_glyph_dsc = GetGlyphDsc;
+    base_font.get_glyph_bitmap = GetGlyphBitmap;
+    std::vector<uint8_t> draw_data(GLYPH_SIZE * GLYPH_SIZE);
+    lv_draw_buf_t draw_buf = {};
+    draw_buf.header.stride = GLYPH_SIZE;
+    draw_buf.data = draw_data.data();
+    // 一段回复里常用的几十个汉字反复出现
+    uint32_t letter = 0;
+    Run("Glyph expand (no cache)", 100000, [&]() {
+        DrawGlyph(&base_font, 0x4e00 + letter++ % 64, &draw_buf);
+    });
+    GlyphCache cache(&base_font, 64 * GLYPH_SIZE * GLYPH_SIZE);
+    Run("GlyphCache hit", 100000, [&]() {
+        DrawGlyph(cache.font(), 0x4e00 + letter++ % 64, &draw_buf);
+    });
+    // 容量只有一个字形，每次都要展开并替换
+    GlyphCache small_cache(&base_font, GLYPH_SIZE * GLYPH_SIZE);
+    Run("GlyphCache miss", 100000, [&]() {
+        DrawGlyph(small_cache.font(), 0x4e00 + letter++ % 64, &draw_buf);
+    });
+
+    return handled > 0 ? 0 : 1;
+}
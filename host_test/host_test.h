@@ -0,0 +1,78 @@
+#ifndef _HOST_TEST_H
+#define _HOST_TEST_H
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// 极简的主机单元测试框架：TEST 注册用例，EXPECT_* 失败时记录位置并继续执行
+// 每个测试文件编译成独立的可执行文件，由 ctest 运行，返回值非 0 表示失败
+struct HostTestCase {
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<HostTestCase>& HostTestCases() {
+    static std::vector<HostTestCase> cases;
+    return cases;
+}
+
+inline int& HostTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct HostTestRegistrar {
+    HostTestRegistrar(const char* name, std::function<void()> body) {
+        HostTestCases().push_back({name, body});
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static HostTestRegistrar name##_registrar(#name, name); \
+    static void name()
+
+#define EXPECT_TRUE(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #cond); \
+            HostTestFailures()++; \
+        } \
+    } while (0)
+
+#define EXPECT_FALSE(cond) EXPECT_TRUE(!(cond))
+
+#define EXPECT_EQ(a, b) \
+    do { \
+        auto _a = (a); \
+        auto _b = (b); \
+        if (!(_a == _b)) { \
+            fprintf(stderr, "%s:%d: expected %s == %s (%lld vs %lld)\n", __FILE__, __LINE__, #a, #b, \
+                (long long)_a, (long long)_b); \
+            HostTestFailures()++; \
+        } \
+    } while (0)
+
+#define EXPECT_STREQ(a, b) \
+    do { \
+        const char* _a = (a); \
+        const char* _b = (b); \
+        if (_a == nullptr || _b == nullptr || strcmp(_a, _b) != 0) { \
+            fprintf(stderr, "%s:%d: expected %s == \"%s\", got \"%s\"\n", __FILE__, __LINE__, #a, \
+                _b ? _b : "(null)", _a ? _a : "(null)"); \
+            HostTestFailures()++; \
+        } \
+    } while (0)
+
+inline int RunHostTests() {
+    for (auto& test : HostTestCases()) {
+        int before = HostTestFailures();
+        test.body();
+        printf("[%s] %s\n", HostTestFailures() == before ? "PASS" : "FAIL", test.name);
+    }
+    return HostTestFailures() == 0 ? 0 : 1;
+}
+
+#endif // _HOST_TEST_H
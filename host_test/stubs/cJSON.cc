@@ -0,0 +1,71 @@
+#include "cJSON.h"
+
+#include <cstdlib>
+#include <cstring>
+
+static cJSON* NewItem(int type) {
+    auto item = static_cast<cJSON*>(calloc(1, sizeof(cJSON)));
+    item->type = type;
+    return item;
+}
+
+static cJSON* AddItem(cJSON* object, const char* name, cJSON* item) {
+    item->string = strdup(name);
+    cJSON** tail = &object->child;
+    while (*tail != nullptr) {
+        tail = &(*tail)->next;
+    }
+    *tail = item;
+    return item;
+}
+
+cJSON* cJSON_ParseWithLength(const char* value, size_t buffer_length) {
+    return nullptr;
+}
+
+cJSON* cJSON_CreateObject(void) {
+    return NewItem(cJSON_Object);
+}
+
+cJSON* cJSON_AddStringToObject(cJSON* object, const char* name, const char* string) {
+    auto item = NewItem(cJSON_String);
+    item->valuestring = strdup(string);
+    return AddItem(object, name, item);
+}
+
+cJSON* cJSON_AddNumberToObject(cJSON* object, const char* name, double number) {
+    auto item = NewItem(cJSON_Number);
+    item->valuedouble = number;
+    return AddItem(object, name, item);
+}
+
+cJSON* cJSON_GetObjectItem(const cJSON* object, const char* string) {
+    if (object == nullptr || string == nullptr) {
+        return nullptr;
+    }
+    for (cJSON* item = object->child; item != nullptr; item = item->next) {
+        if (strcasecmp(item->string, string) == 0) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+char* cJSON_GetStringValue(const cJSON* item) {
+    return cJSON_IsString(item) ? item->valuestring : nullptr;
+}
+
+int cJSON_IsString(const cJSON* item) {
+    return item != nullptr && item->type == cJSON_String;
+}
+
+void cJSON_Delete(cJSON* item) {
+    while (item != nullptr) {
+        cJSON* next = item->next;
+        cJSON_Delete(item->child);
+        free(item->valuestring);
+        free(item->string);
+        free(item);
+        item = next;
+    }
+}
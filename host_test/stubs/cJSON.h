@@ -0,0 +1,32 @@
+#ifndef _HOST_CJSON_H
+#define _HOST_CJSON_H
+
+// 主机测试用的最小 cJSON 子集，只支持由字符串和数字成员组成的单层对象
+// 接口与 cJSON 保持一致，被测代码无需修改
+
+#include <stddef.h>
+
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Object (1 << 6)
+
+typedef struct cJSON {
+    struct cJSON* next;
+    struct cJSON* child;
+    int type;
+    char* valuestring;
+    double valuedouble;
+    char* string;
+} cJSON;
+
+// 主机上不实现完整解析，总是返回 NULL，走 cJSON 回退路径的代码按解析失败处理
+cJSON* cJSON_ParseWithLength(const char* value, size_t buffer_length);
+cJSON* cJSON_CreateObject(void);
+cJSON* cJSON_AddStringToObject(cJSON* object, const char* name, const char* string);
+cJSON* cJSON_AddNumberToObject(cJSON* object, const char* name, double number);
+cJSON* cJSON_GetObjectItem(const cJSON* object, const char* string);
+char* cJSON_GetStringValue(const cJSON* item);
+int cJSON_IsString(const cJSON* item);
+void cJSON_Delete(cJSON* item);
+
+#endif // _HOST_CJSON_H
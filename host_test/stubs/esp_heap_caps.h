@@ -0,0 +1,19 @@
+#ifndef _HOST_ESP_HEAP_CAPS_H
+#define _HOST_ESP_HEAP_CAPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+// 主机上没有 PSRAM，所有能力都从普通堆分配
+inline void* heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+inline void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) { return calloc(n, size); }
+inline void heap_caps_free(void* ptr) { free(ptr); }
+inline size_t heap_caps_get_free_size(uint32_t caps) { return 1 << 20; }
+
+#endif // _HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,12 @@
+#ifndef _HOST_ESP_LOG_H
+#define _HOST_ESP_LOG_H
+
+#include <cstdio>
+
+// 主机测试只输出错误和警告，避免干扰测试结果
+#define ESP_LOGE(tag, format, ...) fprintf(stderr, "E (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fprintf(stderr, "W (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) do { if (0) printf("%s " format, tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, format, ...) do { if (0) printf("%s " format, tag, ##__VA_ARGS__); } while (0)
+
+#endif // _HOST_ESP_LOG_H
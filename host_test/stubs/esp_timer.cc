@@ -0,0 +1,68 @@
+#include "esp_timer.h"
+
+#include <chrono>
+#include <cstring>
+#include <list>
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    bool active;
+    bool periodic;
+};
+
+// 不析构，单例在退出时删除定时器也不会访问已销毁的列表
+static std::list<esp_timer_handle_t>& Timers() {
+    static auto timers = new std::list<esp_timer_handle_t>();
+    return *timers;
+}
+
+int64_t esp_timer_get_time() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out_handle) {
+    *out_handle = new esp_timer{*args, false, false};
+    Timers().push_back(*out_handle);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    timer->active = true;
+    timer->periodic = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    timer->active = true;
+    timer->periodic = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    Timers().remove(timer);
+    delete timer;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return timer->active;
+}
+
+bool esp_timer_host_fire(const char* name) {
+    for (auto timer : Timers()) {
+        if (timer->active && strcmp(timer->args.name, name) == 0) {
+            if (!timer->periodic) {
+                timer->active = false;
+            }
+            timer->args.callback(timer->args.arg);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,34 @@
+#ifndef _HOST_ESP_TIMER_H
+#define _HOST_ESP_TIMER_H
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+// 主机上的定时器只记录参数，不会自动触发回调，测试用 esp_timer_host_fire 手动触发
+typedef struct esp_timer* esp_timer_handle_t;
+
+typedef enum {
+    ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct {
+    void (*callback)(void* arg);
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time();
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+bool esp_timer_is_active(esp_timer_handle_t timer);
+
+// 仅主机测试使用：触发一次名为 name 且正在运行的定时器，单次定时器触发后停止，没有找到时返回 false
+bool esp_timer_host_fire(const char* name);
+
+#endif // _HOST_ESP_TIMER_H
@@ -0,0 +1,58 @@
+#ifndef _HOST_LVGL_H
+#define _HOST_LVGL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 只包含主机测试用到的 LVGL 9.2 字体接口，字段名和取值与 LVGL 一致
+struct lv_font_t;
+
+typedef enum {
+    LV_FONT_GLYPH_FORMAT_NONE = 0,
+    LV_FONT_GLYPH_FORMAT_A1 = 0x01,
+    LV_FONT_GLYPH_FORMAT_A2 = 0x02,
+    LV_FONT_GLYPH_FORMAT_A4 = 0x04,
+    LV_FONT_GLYPH_FORMAT_A8 = 0x08,
+    LV_FONT_GLYPH_FORMAT_IMAGE = 0x09,
+    LV_FONT_GLYPH_FORMAT_VECTOR = 0x0A,
+} lv_font_glyph_format_t;
+
+typedef struct {
+    const lv_font_t* resolved_font;
+    uint16_t adv_w;
+    uint16_t box_w;
+    uint16_t box_h;
+    int16_t ofs_x;
+    int16_t ofs_y;
+    lv_font_glyph_format_t format;
+    uint8_t is_placeholder;
+    union {
+        uint32_t index;
+        const void* src;
+    } gid;
+} lv_font_glyph_dsc_t;
+
+typedef struct {
+    uint32_t w;
+    uint32_t h;
+    uint32_t stride;
+} lv_image_header_t;
+
+typedef struct {
+    lv_image_header_t header;
+    uint32_t data_size;
+    uint8_t* data;
+} lv_draw_buf_t;
+
+struct lv_font_t {
+    bool (*get_glyph_dsc)(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next);
+    const void* (*get_glyph_bitmap)(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf);
+    void (*release_glyph)(const lv_font_t* font, lv_font_glyph_dsc_t* dsc);
+    int32_t line_height;
+    int32_t base_line;
+    const void* dsc;
+    const lv_font_t* fallback;
+    void* user_data;
+};
+
+#endif // _HOST_LVGL_H
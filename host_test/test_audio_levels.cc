@@ -0,0 +1,131 @@
+#include "host_test.h"
+#include "audio_levels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#define SAMPLE_RATE 16000
+// 60 ms 一帧，与 Opus 帧长一致
+#define FRAME_SAMPLES 960
+
+static std::vector<int16_t> Sine(double frequency, double amplitude, size_t samples, int channels = 1) {
+    std::vector<int16_t> pcm(samples * channels);
+    for (size_t i = 0; i < samples; i++) {
+        for (int c = 0; c < channels; c++) {
+            // 只有第一个声道是被测信号，其余声道填满幅噪声
+            pcm[i * channels + c] = c == 0 ? static_cast<int16_t>(amplitude * 32767 * sin(2 * M_PI * frequency * i / SAMPLE_RATE))
+                                           : static_cast<int16_t>(rand() % 65536 - 32768);
+        }
+    }
+    return pcm;
+}
+
+static int LoudestBand(const AudioLevels& levels) {
+    int loudest = 0;
+    for (int b = 1; b < AUDIO_LEVEL_BANDS; b++) {
+        if (levels.bands[b] > levels.bands[loudest]) {
+            loudest = b;
+        }
+    }
+    return loudest;
+}
+
+// 先送入一帧让滤波器进入稳态，返回下一帧的结果
+static AudioLevels SteadyLevels(AudioLevelAnalyzer& analyzer, const std::vector<int16_t>& pcm, int stride = 1) {
+    analyzer.Analyze(pcm.data(), pcm.size(), stride, SAMPLE_RATE);
+    return analyzer.Analyze(pcm.data(), pcm.size(), stride, SAMPLE_RATE);
+}
+
+TEST(SilenceIsZero) {
+    AudioLevelAnalyzer analyzer;
+    std::vector<int16_t> pcm(FRAME_SAMPLES);
+    auto levels = analyzer.Analyze(pcm.data(), pcm.size(), 1, SAMPLE_RATE);
+    EXPECT_EQ(levels.rms, 0);
+    for (int b = 0; b < AUDIO_LEVEL_BANDS; b++) {
+        EXPECT_EQ(levels.bands[b], 0);
+    }
+}
+
+TEST(EmptyInputIsZero) {
+    AudioLevelAnalyzer analyzer;
+    int16_t sample = 1000;
+    EXPECT_EQ(analyzer.Analyze(&sample, 0, 1, SAMPLE_RATE).rms, 0);
+    EXPECT_EQ(analyzer.Analyze(&sample, 1, 2, SAMPLE_RATE).rms, 0);
+    EXPECT_EQ(analyzer.Analyze(&sample, 1, 1, 0).rms, 0);
+}
+
+TEST(FullScaleSineIsFullLevel) {
+    AudioLevelAnalyzer analyzer;
+    auto levels = SteadyLevels(analyzer, Sine(1000, 1.0, FRAME_SAMPLES));
+    EXPECT_TRUE(levels.rms >= 250);
+}
+
+// 每降低 20 dB 约下降 85
+TEST(LevelTracksLoudness) {
+    AudioLevelAnalyzer analyzer;
+    int loud = SteadyLevels(analyzer, Sine(1000, 1.0, FRAME_SAMPLES)).rms;
+    int quiet = SteadyLevels(analyzer, Sine(1000, 0.1, FRAME_SAMPLES)).rms;
+    EXPECT_TRUE(std::abs(loud - quiet - 85) <= 3);
+}
+
+TEST(SineLandsInItsBand) {
+    const double frequencies[AUDIO_LEVEL_BANDS] = { 100, 550, 1700, 6000 };
+    for (int b = 0; b < AUDIO_LEVEL_BANDS; b++) {
+        AudioLevelAnalyzer analyzer;
+        auto levels = SteadyLevels(analyzer, Sine(frequencies[b], 0.5, FRAME_SAMPLES));
+        EXPECT_EQ(LoudestBand(levels), b);
+    }
+}
+
+// 只分析交错数据中的第一个声道
+TEST(StrideSelectsFirstChannel) {
+    AudioLevelAnalyzer mono, stereo;
+    auto expected = SteadyLevels(mono, Sine(300, 0.5, FRAME_SAMPLES));
+    auto levels = SteadyLevels(stereo, Sine(300, 0.5, FRAME_SAMPLES, 2), 2);
+    EXPECT_EQ(levels.rms, expected.rms);
+    for (int b = 0; b < AUDIO_LEVEL_BANDS; b++) {
+        EXPECT_EQ(levels.bands[b], expected.bands[b]);
+    }
+}
+
+// 滤波器状态跨帧保留：同一段信号按整段分析和拆成 10 ms（正好一个周期）的小帧连续分析，各频段的结果一致
+// 如果每帧都从零开始滤波，低通的起始瞬态会被算进较高的频段
+TEST(FilterStateCarriesAcrossFrames) {
+    auto pcm = Sine(100, 0.5, FRAME_SAMPLES * 2);
+    AudioLevelAnalyzer whole, split;
+    whole.Analyze(pcm.data(), FRAME_SAMPLES, 1, SAMPLE_RATE);
+    auto expected = whole.Analyze(pcm.data() + FRAME_SAMPLES, FRAME_SAMPLES, 1, SAMPLE_RATE);
+
+    split.Analyze(pcm.data(), FRAME_SAMPLES, 1, SAMPLE_RATE);
+    int worst = 0;
+    for (size_t offset = FRAME_SAMPLES; offset < pcm.size(); offset += 160) {
+        auto levels = split.Analyze(pcm.data() + offset, 160, 1, SAMPLE_RATE);
+        for (int b = 0; b < AUDIO_LEVEL_BANDS; b++) {
+            worst = std::max(worst, std::abs(levels.bands[b] - expected.bands[b]));
+        }
+    }
+    EXPECT_TRUE(worst <= 1);
+}
+
+// 输入和输出各用一个实例，互不影响；Reset 之后与新实例相同
+TEST(InstancesAreIndependent) {
+    auto low = Sine(100, 0.5, FRAME_SAMPLES);
+    auto high = Sine(6000, 0.5, FRAME_SAMPLES);
+    AudioLevelAnalyzer input, output, fresh;
+    input.Analyze(low.data(), low.size(), 1, SAMPLE_RATE);
+    output.Analyze(high.data(), high.size(), 1, SAMPLE_RATE);
+    auto a = input.Analyze(low.data(), 80, 1, SAMPLE_RATE);
+    AudioLevelAnalyzer reference;
+    reference.Analyze(low.data(), low.size(), 1, SAMPLE_RATE);
+    auto b = reference.Analyze(low.data(), 80, 1, SAMPLE_RATE);
+    EXPECT_EQ(a.bands[0], b.bands[0]);
+
+    input.Reset();
+    auto c = input.Analyze(low.data(), 80, 1, SAMPLE_RATE);
+    auto d = fresh.Analyze(low.data(), 80, 1, SAMPLE_RATE);
+    for (int band = 0; band < AUDIO_LEVEL_BANDS; band++) {
+        EXPECT_EQ(c.bands[band], d.bands[band]);
+    }
+}
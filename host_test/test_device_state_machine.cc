@@ -0,0 +1,175 @@
+#include "host_test.h"
+#include "device_state_machine.h"
+
+#include <vector>
+#include <utility>
+
+// 从上电到各个状态的事件序列
+static const std::vector<DeviceEvent>& PathTo(DeviceState state) {
+    static const std::vector<DeviceEvent> paths[kDeviceStateCount] = {
+        {},                                                         // unknown
+        { kDeviceEventStart },                                      // starting
+        { kDeviceEventStart, kDeviceEventConfigureWifi },           // configuring
+        { kDeviceEventStart, kDeviceEventReady },                   // idle
+        { kDeviceEventStart, kDeviceEventReady, kDeviceEventConnect },
+        { kDeviceEventStart, kDeviceEventReady, kDeviceEventListen },
+        { kDeviceEventStart, kDeviceEventReady, kDeviceEventSpeak },
+        { kDeviceEventStart, kDeviceEventReady, kDeviceEventUpgrade },
+        { kDeviceEventStart, kDeviceEventActivate },                // activating
+        {},                                                         // fatal_error 没有入口
+    };
+    return paths[state];
+}
+
+static bool Reach(DeviceStateMachine& machine, DeviceState state) {
+    for (auto event : PathTo(state)) {
+        if (!machine.HandleEvent(event)) {
+            return false;
+        }
+    }
+    return machine.state() == state;
+}
+
+struct Expected {
+    DeviceState from;
+    DeviceEvent event;
+    DeviceState to;
+};
+
+// 与 device_state_machine.cc 中的转换表独立维护，任何一方修改都会让测试失败
+static const Expected kExpected[] = {
+    { kDeviceStateUnknown,    kDeviceEventStart,         kDeviceStateStarting },
+    { kDeviceStateStarting,   kDeviceEventConfigureWifi, kDeviceStateWifiConfiguring },
+    { kDeviceStateStarting,   kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateStarting,   kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateStarting,   kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateIdle,       kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateIdle,       kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateIdle,       kDeviceEventConnect,       kDeviceStateConnecting },
+    { kDeviceStateIdle,       kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateIdle,       kDeviceEventSpeak,         kDeviceStateSpeaking },
+    { kDeviceStateIdle,       kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateIdle,       kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateIdle,       kDeviceEventUpgrade,       kDeviceStateUpgrading },
+    { kDeviceStateConnecting, kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateConnecting, kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateConnecting, kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateListening,  kDeviceEventSpeak,         kDeviceStateSpeaking },
+    { kDeviceStateListening,  kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateListening,  kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateSpeaking,   kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateSpeaking,   kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateSpeaking,   kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateActivating, kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateActivating, kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateActivating, kDeviceEventReset,         kDeviceStateIdle },
+};
+
+static const Expected* FindExpected(DeviceState from, DeviceEvent event) {
+    for (auto& expected : kExpected) {
+        if (expected.from == from && expected.event == event) {
+            return &expected;
+        }
+    }
+    return nullptr;
+}
+
+TEST(InitialState) {
+    DeviceStateMachine machine;
+    EXPECT_EQ(machine.state(), kDeviceStateUnknown);
+}
+
+// 遍历所有可到达状态与所有事件的组合，结果必须与期望表完全一致
+TEST(TransitionTableIsExhaustive) {
+    for (int s = 0; s < kDeviceStateCount; s++) {
+        auto state = (DeviceState)s;
+        if (state == kDeviceStateFatalError) {
+            continue;
+        }
+        for (int e = 0; e < kDeviceEventCount; e++) {
+            auto event = (DeviceEvent)e;
+            DeviceStateMachine machine;
+            EXPECT_TRUE(Reach(machine, state));
+
+            std::vector<std::pair<DeviceState, DeviceState>> changes;
+            machine.OnStateChanged([&changes](DeviceState previous, DeviceState current) {
+                changes.emplace_back(previous, current);
+            });
+
+            auto expected = FindExpected(state, event);
+            bool accepted = machine.HandleEvent(event);
+            if (expected == nullptr) {
+                if (accepted) {
+                    fprintf(stderr, "event %s unexpectedly accepted in %s\n",
+                        DeviceStateMachine::GetEventName(event), DeviceStateMachine::GetStateName(state));
+                }
+                EXPECT_FALSE(accepted);
+                EXPECT_EQ(machine.state(), state);
+                EXPECT_TRUE(changes.empty());
+                continue;
+            }
+            if (!accepted) {
+                fprintf(stderr, "event %s unexpectedly rejected in %s\n",
+                    DeviceStateMachine::GetEventName(event), DeviceStateMachine::GetStateName(state));
+            }
+            EXPECT_TRUE(accepted);
+            EXPECT_EQ(machine.state(), expected->to);
+            if (expected->to == state) {
+                // 允许但无需处理的事件不触发回调
+                EXPECT_TRUE(changes.empty());
+            } else {
+                EXPECT_EQ(changes.size(), 1u);
+                if (changes.size() == 1) {
+                    EXPECT_EQ(changes[0].first, state);
+                    EXPECT_EQ(changes[0].second, expected->to);
+                }
+            }
+        }
+    }
+}
+
+TEST(FatalErrorIsUnreachable) {
+    for (auto& expected : kExpected) {
+        EXPECT_TRUE(expected.to != kDeviceStateFatalError);
+    }
+}
+
+// 回调中读取到的已经是新状态，便于转换动作根据当前状态工作
+TEST(CallbackSeesNewState) {
+    DeviceStateMachine machine;
+    DeviceState seen = kDeviceStateUnknown;
+    machine.OnStateChanged([&machine, &seen](DeviceState previous, DeviceState current) {
+        seen = machine.state();
+    });
+    EXPECT_TRUE(machine.HandleEvent(kDeviceEventStart));
+    EXPECT_EQ(seen, kDeviceStateStarting);
+}
+
+TEST(ConversationCycle) {
+    DeviceStateMachine machine;
+    EXPECT_TRUE(Reach(machine, kDeviceStateIdle));
+    std::vector<DeviceState> visited;
+    machine.OnStateChanged([&visited](DeviceState previous, DeviceState current) {
+        visited.push_back(current);
+    });
+    for (auto event : { kDeviceEventConnect, kDeviceEventListen, kDeviceEventSpeak, kDeviceEventListen,
+        kDeviceEventSpeak, kDeviceEventStop }) {
+        EXPECT_TRUE(machine.HandleEvent(event));
+    }
+    std::vector<DeviceState> expected = { kDeviceStateConnecting, kDeviceStateListening, kDeviceStateSpeaking,
+        kDeviceStateListening, kDeviceStateSpeaking, kDeviceStateIdle };
+    EXPECT_TRUE(visited == expected);
+    // 升级过程中不允许再进入对话
+    EXPECT_TRUE(machine.HandleEvent(kDeviceEventUpgrade));
+    EXPECT_FALSE(machine.HandleEvent(kDeviceEventListen));
+    EXPECT_FALSE(machine.HandleEvent(kDeviceEventStop));
+    EXPECT_EQ(machine.state(), kDeviceStateUpgrading);
+}
+
+TEST(Names) {
+    EXPECT_STREQ(DeviceStateMachine::GetStateName(kDeviceStateIdle), "idle");
+    EXPECT_STREQ(DeviceStateMachine::GetStateName(kDeviceStateCount), "invalid_state");
+    EXPECT_STREQ(DeviceStateMachine::GetStateName((DeviceState)-1), "invalid_state");
+    EXPECT_STREQ(DeviceStateMachine::GetEventName(kDeviceEventUpgrade), "upgrade");
+    EXPECT_STREQ(DeviceStateMachine::GetEventName(kDeviceEventCount), "invalid_event");
+}
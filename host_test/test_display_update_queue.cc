@@ -0,0 +1,115 @@
+#include "host_test.h"
+#include "display_update_queue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(FirstPostStartsFrame) {
+    DisplayUpdateQueue queue;
+    EXPECT_TRUE(queue.PostStatus("a"));
+    EXPECT_FALSE(queue.PostEmotion("happy"));
+    EXPECT_FALSE(queue.PostChatMessage("user", "hi"));
+    queue.Take();
+    EXPECT_TRUE(queue.PostStatus("b"));
+    EXPECT_EQ((int)queue.received(), 4);
+}
+
+TEST(EmptyQueueTakesNothing) {
+    DisplayUpdateQueue queue;
+    auto updates = queue.Take();
+    EXPECT_EQ(updates.kinds, 0);
+    EXPECT_TRUE(updates.chat_messages.empty());
+}
+
+// 同一帧内同类更新只保留最新的一次
+TEST(StatusKeepsLatest) {
+    DisplayUpdateQueue queue;
+    queue.PostStatus("connecting");
+    queue.PostStatus("listening");
+    auto updates = queue.Take();
+    EXPECT_EQ(updates.kinds, DisplayUpdateQueue::kStatus);
+    EXPECT_TRUE(updates.status == "listening");
+    EXPECT_EQ(queue.Take().kinds, 0);
+}
+
+// 图标和表情共用一个标签，后提交的生效
+TEST(IconAndEmotionShareSlot) {
+    DisplayUpdateQueue queue;
+    queue.PostEmotion("happy");
+    queue.PostIcon("download");
+    auto updates = queue.Take();
+    EXPECT_EQ(updates.kinds, DisplayUpdateQueue::kEmotion);
+    EXPECT_TRUE(updates.emotion == "download");
+    EXPECT_TRUE(updates.emotion_is_icon);
+
+    queue.PostIcon("download");
+    queue.PostEmotion("sad");
+    updates = queue.Take();
+    EXPECT_TRUE(updates.emotion == "sad");
+    EXPECT_FALSE(updates.emotion_is_icon);
+}
+
+// 聊天消息按条追加，同一帧内的多条都保留并保持顺序
+TEST(ChatMessagesAreQueuedInOrder) {
+    DisplayUpdateQueue queue;
+    queue.PostChatMessage("user", "今天天气怎么样");
+    queue.PostChatMessage("assistant", "今天晴。");
+    queue.PostChatMessage("assistant", "最高气温二十六度。");
+    auto updates = queue.Take();
+    EXPECT_EQ(updates.kinds, DisplayUpdateQueue::kChatMessage);
+    EXPECT_EQ((int)updates.chat_messages.size(), 3);
+    EXPECT_TRUE(updates.chat_messages[0].first == "user");
+    EXPECT_TRUE(updates.chat_messages[2].second == "最高气温二十六度。");
+}
+
+// 系统消息和清空会替换整个聊天区，之前未应用的消息不再需要
+TEST(SystemOrEmptyMessageDropsQueued) {
+    DisplayUpdateQueue queue;
+    queue.PostChatMessage("user", "hi");
+    queue.PostChatMessage("system", "Version 1.0");
+    auto updates = queue.Take();
+    EXPECT_EQ((int)updates.chat_messages.size(), 1);
+    EXPECT_TRUE(updates.chat_messages[0].first == "system");
+
+    queue.PostChatMessage("assistant", "hello");
+    queue.PostChatMessage("assistant", "");
+    queue.PostChatMessage("user", "again");
+    updates = queue.Take();
+    EXPECT_EQ((int)updates.chat_messages.size(), 2);
+    EXPECT_TRUE(updates.chat_messages[0].second.empty());
+    EXPECT_TRUE(updates.chat_messages[1].second == "again");
+}
+
+// 多个任务同时提交时不丢计数，每一帧最多需要启动一次定时器
+TEST(ConcurrentPosts) {
+    DisplayUpdateQueue queue;
+    const int threads = 4, posts = 2000;
+    std::vector<std::thread> workers;
+    std::atomic<int> frames{0};
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&queue, &frames, t]() {
+            for (int i = 0; i < posts; i++) {
+                bool first = t % 2 ? queue.PostStatus("status") : queue.PostChatMessage("assistant", "text");
+                if (first) {
+                    frames++;
+                }
+            }
+        });
+    }
+    int messages = 0, takes = 0;
+    while (takes < 100) {
+        auto updates = queue.Take();
+        messages += updates.chat_messages.size();
+        takes++;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    messages += queue.Take().chat_messages.size();
+    EXPECT_EQ((int)queue.received(), threads * posts);
+    EXPECT_EQ(messages, threads / 2 * posts);
+    EXPECT_TRUE(frames.load() >= 1);
+    EXPECT_TRUE(frames.load() <= takes + 1);
+}
@@ -0,0 +1,149 @@
+#include "host_test.h"
+#include "glyph_cache.h"
+
+#include <cstring>
+#include <vector>
+
+#define GLYPH_SIZE 16
+// 绘制缓冲区每行比字形宽，检查按 stride 复制
+#define DRAW_STRIDE 20
+
+// 假的原字体：位图内容由字形编号决定，记录展开次数
+static int expand_calls = 0;
+static const lv_font_t* last_resolved_font = nullptr;
+
+static bool BaseGetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next) {
+    dsc->gid.index = letter;
+    dsc->box_w = GLYPH_SIZE;
+    dsc->box_h = GLYPH_SIZE;
+    dsc->format = LV_FONT_GLYPH_FORMAT_A8;
+    return true;
+}
+
+static const void* BaseGetGlyphBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    expand_calls++;
+    last_resolved_font = dsc->resolved_font;
+    if (draw_buf == nullptr) {
+        return nullptr;
+    }
+    for (int y = 0; y < dsc->box_h; y++) {
+        for (int x = 0; x < dsc->box_w; x++) {
+            draw_buf->data[y * draw_buf->header.stride + x] = static_cast<uint8_t>(dsc->gid.index * 31 + y * 7 + x);
+        }
+    }
+    return draw_buf;
+}
+
+static lv_font_t MakeBaseFont() {
+    lv_font_t font = {};
+    font.get_glyph_dsc = BaseGetGlyphDsc;
+    font.get_glyph_bitmap = BaseGetGlyphBitmap;
+    font.line_height = 24;
+    return font;
+}
+
+struct DrawBuffer {
+    std::vector<uint8_t> data = std::vector<uint8_t>(DRAW_STRIDE * GLYPH_SIZE);
+    lv_draw_buf_t buf = {};
+
+    DrawBuffer() {
+        buf.header.stride = DRAW_STRIDE;
+        buf.data = data.data();
+    }
+};
+
+// 与 LVGL 绘制文字时的调用顺序一致：先取描述，再通过解析到的字体取位图
+static const void* Draw(const GlyphCache& cache, uint32_t letter, DrawBuffer& draw,
+    lv_font_glyph_format_t format = LV_FONT_GLYPH_FORMAT_A8, bool with_buffer = true) {
+    auto font = cache.font();
+    lv_font_glyph_dsc_t dsc = {};
+    font->get_glyph_dsc(font, &dsc, letter, 0);
+    dsc.format = format;
+    dsc.resolved_font = font;
+    memset(draw.data.data(), 0, draw.data.size());
+    return font->get_glyph_bitmap(&dsc, with_buffer ? &draw.buf : nullptr);
+}
+
+static bool BitmapMatches(const DrawBuffer& draw, uint32_t letter) {
+    for (int y = 0; y < GLYPH_SIZE; y++) {
+        for (int x = 0; x < GLYPH_SIZE; x++) {
+            if (draw.data[y * DRAW_STRIDE + x] != static_cast<uint8_t>(letter * 31 + y * 7 + x)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST(WrapperKeepsFontMetrics) {
+    auto base = MakeBaseFont();
+    GlyphCache cache(&base, 4096);
+    EXPECT_EQ(cache.font()->line_height, 24);
+    EXPECT_TRUE(cache.font()->user_data == &cache);
+    lv_font_glyph_dsc_t dsc = {};
+    EXPECT_TRUE(cache.font()->get_glyph_dsc(cache.font(), &dsc, 0x4f60, 0));
+    EXPECT_EQ((int)dsc.gid.index, 0x4f60);
+}
+
+TEST(SecondDrawIsCacheHit) {
+    auto base = MakeBaseFont();
+    GlyphCache cache(&base, 4096);
+    DrawBuffer draw;
+    expand_calls = 0;
+
+    EXPECT_TRUE(Draw(cache, 0x4f60, draw) == &draw.buf);
+    EXPECT_EQ(expand_calls, 1);
+    EXPECT_TRUE(last_resolved_font == &base);
+    EXPECT_TRUE(BitmapMatches(draw, 0x4f60));
+
+    EXPECT_TRUE(Draw(cache, 0x4f60, draw) == &draw.buf);
+    EXPECT_EQ(expand_calls, 1);
+    EXPECT_TRUE(BitmapMatches(draw, 0x4f60));
+}
+
+// 容量只够两个字形时淘汰最久未使用的
+TEST(EvictsLeastRecentlyUsed) {
+    auto base = MakeBaseFont();
+    GlyphCache cache(&base, GLYPH_SIZE * GLYPH_SIZE * 2);
+    DrawBuffer draw;
+    expand_calls = 0;
+
+    Draw(cache, 'a', draw);
+    Draw(cache, 'b', draw);
+    Draw(cache, 'a', draw);
+    EXPECT_EQ(expand_calls, 2);
+    Draw(cache, 'c', draw);
+    EXPECT_EQ(expand_calls, 3);
+
+    Draw(cache, 'a', draw);
+    EXPECT_EQ(expand_calls, 3);
+    EXPECT_TRUE(BitmapMatches(draw, 'a'));
+    Draw(cache, 'b', draw);
+    EXPECT_EQ(expand_calls, 4);
+    EXPECT_TRUE(BitmapMatches(draw, 'b'));
+}
+
+TEST(GlyphLargerThanCacheIsNotStored) {
+    auto base = MakeBaseFont();
+    GlyphCache cache(&base, GLYPH_SIZE * GLYPH_SIZE - 1);
+    DrawBuffer draw;
+    expand_calls = 0;
+    Draw(cache, 'a', draw);
+    Draw(cache, 'a', draw);
+    EXPECT_EQ(expand_calls, 2);
+    EXPECT_TRUE(BitmapMatches(draw, 'a'));
+}
+
+// 图片、矢量字形和没有绘制缓冲区的调用直接转发给原字体
+TEST(NonBitmapGlyphsBypassCache) {
+    auto base = MakeBaseFont();
+    GlyphCache cache(&base, 4096);
+    DrawBuffer draw;
+    expand_calls = 0;
+    Draw(cache, 'a', draw, LV_FONT_GLYPH_FORMAT_IMAGE);
+    Draw(cache, 'a', draw, LV_FONT_GLYPH_FORMAT_IMAGE);
+    EXPECT_EQ(expand_calls, 2);
+    EXPECT_TRUE(Draw(cache, 'b', draw, LV_FONT_GLYPH_FORMAT_A8, false) == nullptr);
+    EXPECT_TRUE(Draw(cache, 'b', draw, LV_FONT_GLYPH_FORMAT_A8, false) == nullptr);
+    EXPECT_EQ(expand_calls, 4);
+}
@@ -0,0 +1,156 @@
+#include "host_test.h"
+#include "json_reader.h"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+
+static const char* const kNames[] = { "type", "state", "text", "emotion", "session_id" };
+static const size_t kCount = sizeof(kNames) / sizeof(kNames[0]);
+
+// 每次解析都复制到刚好大小的堆缓冲区，越界读写会被 AddressSanitizer 发现
+struct ParseResult {
+    bool ok;
+    std::vector<std::string> values;
+    std::vector<bool> present;
+};
+
+static ParseResult Parse(const std::string& json) {
+    std::unique_ptr<char[]> buffer(new char[json.size()]);
+    memcpy(buffer.get(), json.data(), json.size());
+    const char* values[kCount];
+    ParseResult result;
+    result.ok = JsonReader::ParseStringFields(buffer.get(), json.size(), kNames, values, kCount);
+    for (size_t i = 0; i < kCount; i++) {
+        result.present.push_back(values[i] != nullptr);
+        result.values.push_back(values[i] ? values[i] : "");
+        if (values[i] != nullptr) {
+            EXPECT_TRUE(values[i] >= buffer.get() && values[i] < buffer.get() + json.size());
+        }
+    }
+    return result;
+}
+
+static std::string Nested(int depth) {
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+
+TEST(ExtractsStringFields) {
+    auto r = Parse(R"({"type":"tts","state":"sentence_start","text":"你好","session_id":"abc","n":1.5e3,"b":true,"z":null})");
+    EXPECT_TRUE(r.ok);
+    EXPECT_STREQ(r.values[0].c_str(), "tts");
+    EXPECT_STREQ(r.values[1].c_str(), "sentence_start");
+    EXPECT_STREQ(r.values[2].c_str(), "你好");
+    EXPECT_FALSE(r.present[3]);
+    EXPECT_STREQ(r.values[4].c_str(), "abc");
+}
+
+TEST(NonStringFieldsAreSkipped) {
+    auto r = Parse(R"( { "text" : {"type":"nested"} , "type" : [1, "x", {"a": []}], "state": 3 } )");
+    EXPECT_TRUE(r.ok);
+    // 嵌套对象内的同名字段不属于顶层
+    EXPECT_FALSE(r.present[0]);
+    EXPECT_FALSE(r.present[1]);
+    EXPECT_FALSE(r.present[2]);
+}
+
+TEST(EmptyObject) {
+    auto r = Parse("{}");
+    EXPECT_TRUE(r.ok);
+    EXPECT_FALSE(r.present[0]);
+    EXPECT_TRUE(Parse(" { } ").ok);
+}
+
+TEST(Escapes) {
+    auto r = Parse(R"({"text":"a\"b\\c\/d\b\f\n\r\t\u0041\u00e9\u4e2d"})");
+    EXPECT_TRUE(r.ok);
+    EXPECT_STREQ(r.values[2].c_str(), "a\"b\\c/d\b\f\n\r\tAé中");
+}
+
+TEST(SurrogatePairs) {
+    auto r = Parse(R"({"text":"\ud83d\ude00 \uD834\uDD1E"})");
+    EXPECT_TRUE(r.ok);
+    EXPECT_STREQ(r.values[2].c_str(), "\xF0\x9F\x98\x80 \xF0\x9D\x84\x9E");
+
+    // 孤立的高位或低位代理、高位后跟非低位代理都视为错误
+    EXPECT_FALSE(Parse(R"({"text":"\ud83d"})").ok);
+    EXPECT_FALSE(Parse(R"({"text":"\ud83dx"})").ok);
+    EXPECT_FALSE(Parse(R"({"text":"\ud83d\u0041"})").ok);
+    EXPECT_FALSE(Parse(R"({"text":"\ude00"})").ok);
+    EXPECT_FALSE(Parse(R"({"text":"\ud83d\ud83d"})").ok);
+    // 在被跳过的字段中同样校验
+    EXPECT_FALSE(Parse(R"({"other":"\ude00","type":"x"})").ok);
+}
+
+TEST(DepthLimit) {
+    // 顶层对象的值从深度 1 开始，最多允许 15 层嵌套容器
+    EXPECT_TRUE(Parse("{\"a\":" + Nested(15) + ",\"type\":\"ok\"}").ok);
+    EXPECT_FALSE(Parse("{\"a\":" + Nested(16) + "}").ok);
+    // 深度远超限制时也不会耗尽栈
+    EXPECT_FALSE(Parse("{\"a\":" + std::string(100000, '[')).ok);
+    std::string objects;
+    for (int i = 0; i < 20; i++) {
+        objects += "{\"k\":";
+    }
+    objects += "1";
+    objects += std::string(20, '}');
+    EXPECT_FALSE(Parse("{\"a\":" + objects + "}").ok);
+}
+
+TEST(RejectsMalformed) {
+    const char* cases[] = {
+        "", " ", "[]", "\"type\"", "{", "{\"type\"", "{\"type\":", "{\"type\":\"x\"", "{\"type\":\"x\",}",
+        "{\"type\" \"x\"}", "{type:\"x\"}", "{\"type\":\"x\" \"state\":\"y\"}", "{\"a\":tru}", "{\"a\":nul}",
+        "{\"a\":-}", "{\"a\":[1,]x}", "{\"a\":\"\\x\"}", "{\"a\":\"\\u12\"}", "{\"a\":\"\\u12G4\"}",
+        "{\"a\":\"line\nbreak\"}", "{\"a\":{\"b\"}}", "{\"a\":[1 2]}",
+    };
+    for (auto json : cases) {
+        if (Parse(json).ok) {
+            fprintf(stderr, "accepted malformed input: %s\n", json);
+            HostTestFailures()++;
+        }
+    }
+}
+
+// 合法消息的每一个前缀（不含完整消息）都必须被拒绝，且不越界读取
+TEST(TruncatedInput) {
+    std::string json = R"({"type":"tts","text":"\ud83d\ude00\n中文","nested":{"a":[1,-2.5e+3,true,false,null,"s"]},"state":"stop"})";
+    EXPECT_TRUE(Parse(json).ok);
+    for (size_t length = 0; length < json.size(); length++) {
+        if (Parse(json.substr(0, length)).ok) {
+            fprintf(stderr, "accepted truncated input of length %zu\n", length);
+            HostTestFailures()++;
+        }
+    }
+}
+
+// 对合法消息做随机变异，只要求不崩溃、不越界，接受时返回的字段指针必须在缓冲区内
+TEST(FuzzMutations) {
+    const std::string seeds[] = {
+        R"({"type":"tts","state":"start","session_id":"0123"})",
+        R"({"type":"iot","commands":[{"name":"Speaker","method":"SetVolume","parameters":{"volume":70}}]})",
+        R"({"type":"llm","text":"\ud83d\ude00","emotion":"happy"})",
+    };
+    const char alphabet[] = "{}[]\":,\\u0123456789abcdefABCDEF -+.eEtrufalsn\n\xe4\xb8\xad";
+    std::mt19937 rng(12345);
+    int accepted = 0;
+    for (int iteration = 0; iteration < 20000; iteration++) {
+        std::string json = seeds[iteration % 3];
+        int mutations = 1 + rng() % 4;
+        for (int m = 0; m < mutations && !json.empty(); m++) {
+            size_t position = rng() % json.size();
+            char c = alphabet[rng() % (sizeof(alphabet) - 1)];
+            switch (rng() % 3) {
+                case 0: json[position] = c; break;
+                case 1: json.insert(json.begin() + position, c); break;
+                default: json.erase(position, 1 + rng() % 3); break;
+            }
+        }
+        if (Parse(json).ok) {
+            accepted++;
+        }
+    }
+    // 部分变异（如修改字符串内容）仍然合法
+    EXPECT_TRUE(accepted > 0);
+}
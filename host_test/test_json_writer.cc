@@ -0,0 +1,126 @@
+#include "host_test.h"
+#include "json_writer.h"
+#include "protocol.h"
+
+#include <climits>
+#include <string>
+#include <vector>
+
+TEST(WritesNestedDocument) {
+    StaticJsonWriter<256> writer;
+    writer.BeginObject()
+        .AddString("type", "hello")
+        .AddInt("version", 3)
+        .AddBool("ok", true);
+    writer.Key("audio_params").BeginObject()
+        .AddString("format", "opus")
+        .AddInt("sample_rate", 16000)
+        .EndObject();
+    writer.Key("list").BeginArray().Int(1).String("two").Null().Bool(false).EndArray();
+    writer.AddRaw("raw", "{\"a\":[1,2]}");
+    writer.EndObject();
+    EXPECT_TRUE(writer.ok());
+    EXPECT_STREQ(writer.c_str(),
+        "{\"type\":\"hello\",\"version\":3,\"ok\":true,\"audio_params\":{\"format\":\"opus\",\"sample_rate\":16000},"
+        "\"list\":[1,\"two\",null,false],\"raw\":{\"a\":[1,2]}}");
+    EXPECT_EQ(writer.size(), strlen(writer.c_str()));
+}
+
+TEST(EscapesStrings) {
+    StaticJsonWriter<128> writer;
+    writer.BeginArray().String("a\"b\\c\n\t\x01").String("中文").String(std::string("x\0y", 3)).EndArray();
+    EXPECT_TRUE(writer.ok());
+    EXPECT_STREQ(writer.c_str(), "[\"a\\\"b\\\\c\\n\\t\\u0001\",\"中文\",\"x\\u0000y\"]");
+}
+
+TEST(IntegerLimits) {
+    StaticJsonWriter<128> writer;
+    writer.BeginArray().Int(0).Int(-1).Int(INT64_MAX).Int(INT64_MIN).EndArray();
+    EXPECT_STREQ(writer.c_str(), "[0,-1,9223372036854775807,-9223372036854775808]");
+}
+
+// 缓冲区不足时 ok() 为 false，已写入的内容仍以 '\0' 结尾且不越界
+TEST(OverflowIsReportedAndBounded) {
+    for (size_t capacity = 0; capacity < 40; capacity++) {
+        std::vector<char> buffer(capacity + 8, '#');
+        JsonWriter writer(buffer.data(), capacity);
+        writer.BeginObject().AddString("session_id", "0123456789").AddInt("n", 42).EndObject();
+        const size_t full = strlen("{\"session_id\":\"0123456789\",\"n\":42}");
+        EXPECT_EQ(writer.ok(), capacity > full);
+        for (size_t i = capacity; i < buffer.size(); i++) {
+            EXPECT_EQ(buffer[i], '#');
+        }
+        if (capacity > 0) {
+            EXPECT_TRUE(writer.size() < capacity);
+            EXPECT_EQ(buffer[writer.size()], '\0');
+        }
+    }
+}
+
+TEST(HeapWriterGrowsUntilFit) {
+    std::string value(1000, 'x');
+    int calls = 0;
+    auto json = HeapJsonWriter::Write(16, [&](JsonWriter& writer) {
+        calls++;
+        writer.BeginObject().AddString("value", value).EndObject();
+    });
+    EXPECT_TRUE(json == "{\"value\":\"" + value + "\"}");
+    EXPECT_TRUE(calls > 1);
+}
+
+TEST(HeapWriterGivesUpAtLimit) {
+    std::string value(70 * 1024, 'x');
+    auto json = HeapJsonWriter::Write(1024, [&](JsonWriter& writer) {
+        writer.String(value);
+    });
+    EXPECT_TRUE(json.empty());
+}
+
+// 用于检查 Protocol 生成的控制消息，不连接任何网络
+class RecordingProtocol : public Protocol {
+public:
+    std::vector<std::string> sent;
+
+    void SetSessionId(const std::string& session_id) { session_id_ = session_id; }
+    virtual void Start() override {}
+    virtual bool OpenAudioChannel() override { return true; }
+    virtual void CloseAudioChannel() override {}
+    virtual bool IsAudioChannelOpened() const override { return true; }
+    virtual void SendAudio(const std::vector<uint8_t>& data) override {}
+
+private:
+    virtual void SendText(const std::string& text) override { sent.push_back(text); }
+};
+
+TEST(ControlMessagesFitOnStack) {
+    RecordingProtocol protocol;
+    protocol.SetSessionId("3f6c2a9e-1b7d-4c55-8a0e-9d2f4b6e8c11");
+    protocol.SendStartListening(kListeningModeAlwaysOn);
+    protocol.SendStopListening();
+    protocol.SendAbortSpeaking(kAbortReasonWakeWordDetected);
+    EXPECT_EQ(protocol.sent.size(), 3u);
+    EXPECT_STREQ(protocol.sent[0].c_str(),
+        "{\"session_id\":\"3f6c2a9e-1b7d-4c55-8a0e-9d2f4b6e8c11\",\"type\":\"listen\",\"state\":\"start\",\"mode\":\"realtime\"}");
+}
+
+// session_id 或唤醒词超过栈缓冲区时改用堆缓冲区，消息不能丢失
+TEST(LongFieldsAreNeverDropped) {
+    RecordingProtocol protocol;
+    std::string session_id(600, 's');
+    std::string wake_word(300, 'w');
+    protocol.SetSessionId(session_id);
+    protocol.SendStartListening(kListeningModeAutoStop);
+    protocol.SendStopListening();
+    protocol.SendAbortSpeaking(kAbortReasonNone);
+    protocol.SendWakeWordDetected(wake_word);
+    protocol.SendIotStates("{\"Speaker\":{\"volume\":70}}");
+    protocol.SendIotDescriptors("[" + std::string(5000, ' ') + "]");
+    EXPECT_EQ(protocol.sent.size(), 6u);
+    for (auto& message : protocol.sent) {
+        EXPECT_TRUE(message.find("\"session_id\":\"" + session_id + "\"") != std::string::npos);
+        EXPECT_EQ(message.back(), '}');
+    }
+    if (protocol.sent.size() == 6) {
+        EXPECT_TRUE(protocol.sent[3].find("\"text\":\"" + wake_word + "\"") != std::string::npos);
+    }
+}
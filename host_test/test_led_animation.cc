@@ -0,0 +1,172 @@
+#include "host_test.h"
+#include "led_animation.h"
+
+#include <vector>
+
+static bool SameColor(const StripColor& a, const StripColor& b) {
+    return a.red == b.red && a.green == b.green && a.blue == b.blue;
+}
+
+static LedAnimationSpec TwoKeyframes(StripColor from, StripColor to, int duration_ms, bool loop) {
+    LedAnimationSpec spec;
+    spec.keyframes = { { 0, from }, { duration_ms, to } };
+    spec.loop = loop;
+    return spec;
+}
+
+TEST(EmptySpecHasNoFrames) {
+    LedAnimationSpec spec;
+    auto animation = LedAnimation::Build(spec, 8);
+    EXPECT_EQ(animation.frame_count(), 0);
+
+    spec.keyframes = { { 0, { 255, 0, 0 } } };
+    EXPECT_EQ(LedAnimation::Build(spec, 0).frame_count(), 0);
+}
+
+TEST(SingleKeyframeIsStaticFrame) {
+    LedAnimationSpec spec;
+    spec.keyframes = { { 0, { 10, 20, 30 } } };
+    auto animation = LedAnimation::Build(spec, 5);
+    EXPECT_EQ(animation.frame_count(), 1);
+    EXPECT_EQ(animation.pixels(), 5);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(SameColor(animation.frame(0)[i], { 10, 20, 30 }));
+    }
+}
+
+// 帧间隔取整到驱动定时器周期的倍数，至少一个周期
+TEST(FrameIntervalRoundsToTick) {
+    LedAnimationSpec spec = TwoKeyframes({}, { 255, 255, 255 }, 1000, true);
+    spec.frame_interval_ms = 25;
+    EXPECT_EQ(LedAnimation::Build(spec, 1).frame_interval_ms(), 30);
+    spec.frame_interval_ms = 24;
+    EXPECT_EQ(LedAnimation::Build(spec, 1).frame_interval_ms(), 20);
+    spec.frame_interval_ms = 1;
+    EXPECT_EQ(LedAnimation::Build(spec, 1).frame_interval_ms(), LED_ANIMATION_TICK_MS);
+}
+
+// 循环动画最后一帧与第一帧重合不重复生成，单次动画包含终点
+TEST(FrameCountLoopAndOneShot) {
+    auto loop = LedAnimation::Build(TwoKeyframes({}, { 255, 0, 0 }, 1000, true), 1);
+    EXPECT_EQ(loop.frame_count(), 50);
+    EXPECT_TRUE(loop.loop());
+
+    auto once = LedAnimation::Build(TwoKeyframes({}, { 255, 0, 0 }, 1000, false), 1);
+    EXPECT_EQ(once.frame_count(), 51);
+    EXPECT_FALSE(once.loop());
+    EXPECT_TRUE(SameColor(once.frame(0)[0], {}));
+    EXPECT_TRUE(SameColor(once.frame(50)[0], { 255, 0, 0 }));
+}
+
+TEST(LinearFadeIsMonotonic) {
+    auto animation = LedAnimation::Build(TwoKeyframes({}, { 255, 128, 0 }, 1000, false), 1);
+    for (int f = 1; f < animation.frame_count(); f++) {
+        EXPECT_TRUE(animation.frame(f)[0].red >= animation.frame(f - 1)[0].red);
+        EXPECT_TRUE(animation.frame(f)[0].green >= animation.frame(f - 1)[0].green);
+        EXPECT_EQ(animation.frame(f)[0].blue, 0);
+    }
+}
+
+// 两端颜色相同时保持原值，不因为查表误差变成 0
+TEST(DimColorIsPreserved) {
+    auto animation = LedAnimation::Build(TwoKeyframes({ 1, 2, 3 }, { 1, 2, 3 }, 200, true), 1);
+    for (int f = 0; f < animation.frame_count(); f++) {
+        EXPECT_TRUE(SameColor(animation.frame(f)[0], { 1, 2, 3 }));
+    }
+}
+
+TEST(StepEasingHoldsColor) {
+    LedAnimationSpec spec;
+    spec.keyframes = { { 0, { 255, 0, 0 } }, { 100, { 0, 255, 0 } }, { 200, { 0, 0, 255 } } };
+    spec.easing = kLedEasingStep;
+    spec.frame_interval_ms = 10;
+    spec.loop = false;
+    auto animation = LedAnimation::Build(spec, 1);
+    EXPECT_EQ(animation.frame_count(), 21);
+    for (int f = 0; f < 10; f++) {
+        EXPECT_TRUE(SameColor(animation.frame(f)[0], { 255, 0, 0 }));
+    }
+    for (int f = 10; f < 20; f++) {
+        EXPECT_TRUE(SameColor(animation.frame(f)[0], { 0, 255, 0 }));
+    }
+    EXPECT_TRUE(SameColor(animation.frame(20)[0], { 0, 0, 255 }));
+}
+
+// 缓入缓出在起点附近比线性慢，中点与线性相同
+TEST(InOutEasingIsSlowAtEnds) {
+    LedAnimationSpec spec = TwoKeyframes({}, { 255, 0, 0 }, 1000, false);
+    spec.frame_interval_ms = 100;
+    auto linear = LedAnimation::Build(spec, 1);
+    spec.easing = kLedEasingInOut;
+    auto in_out = LedAnimation::Build(spec, 1);
+    EXPECT_TRUE(in_out.frame(1)[0].red < linear.frame(1)[0].red);
+    EXPECT_TRUE(in_out.frame(9)[0].red > linear.frame(9)[0].red);
+    EXPECT_EQ(in_out.frame(5)[0].red, linear.frame(5)[0].red);
+}
+
+// 第 i 个灯落后 i * pixel_phase_ms，循环动画在时间轴上回绕
+TEST(PixelPhaseShiftsPixels) {
+    LedAnimationSpec spec;
+    spec.keyframes = { { 0, {} }, { 200, { 255, 0, 0 } }, { 400, {} } };
+    spec.frame_interval_ms = 20;
+    spec.pixel_phase_ms = 60;
+    auto animation = LedAnimation::Build(spec, 4);
+    int shift = spec.pixel_phase_ms / animation.frame_interval_ms();
+    for (int f = 0; f < animation.frame_count(); f++) {
+        for (int i = 1; i < 4; i++) {
+            int source = (f - i * shift + animation.frame_count() * 4) % animation.frame_count();
+            EXPECT_TRUE(SameColor(animation.frame(f)[i], animation.frame(source)[0]));
+        }
+    }
+}
+
+// 从当前画面淡出：第一帧保持原有颜色，超出 from 的灯使用关键帧颜色
+TEST(FadeFromCurrentColors) {
+    std::vector<StripColor> from = { { 255, 0, 0 }, { 0, 255, 0 } };
+    auto animation = LedAnimation::Build(TwoKeyframes({ 0, 0, 50 }, {}, 200, false), 3, &from);
+    EXPECT_TRUE(SameColor(animation.frame(0)[0], { 255, 0, 0 }));
+    EXPECT_TRUE(SameColor(animation.frame(0)[1], { 0, 255, 0 }));
+    EXPECT_TRUE(SameColor(animation.frame(0)[2], { 0, 0, 50 }));
+    int last = animation.frame_count() - 1;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(SameColor(animation.frame(last)[i], {}));
+    }
+}
+
+// 播放器按帧间隔输出，单次动画播完后停止驱动定时器
+TEST(PlayerOutputsFramesOnTicks) {
+    std::vector<StripColor> outputs;
+    LedAnimationPlayer player([&outputs](const StripColor* colors, int count) {
+        outputs.push_back(colors[0]);
+    });
+
+    LedAnimationSpec spec = TwoKeyframes({}, { 255, 0, 0 }, 60, false);
+    spec.frame_interval_ms = 30;
+    player.Play(LedAnimation::Build(spec, 2));
+
+    int ticks = 0;
+    while (esp_timer_host_fire("led_animator")) {
+        ticks++;
+        EXPECT_TRUE(ticks < 100);
+        if (ticks >= 100) {
+            break;
+        }
+    }
+    EXPECT_EQ((int)outputs.size(), 3);
+    EXPECT_EQ(ticks, 1 + 3 + 3);
+    EXPECT_TRUE(SameColor(outputs.back(), { 255, 0, 0 }));
+}
+
+TEST(PlayerLoopsUntilStopped) {
+    int outputs = 0;
+    LedAnimationPlayer player([&outputs](const StripColor* colors, int count) {
+        outputs++;
+    });
+    player.Play(LedAnimation::Build(TwoKeyframes({}, { 0, 0, 255 }, 100, true), 1));
+    for (int i = 0; i < 50; i++) {
+        EXPECT_TRUE(esp_timer_host_fire("led_animator"));
+    }
+    EXPECT_EQ(outputs, 25);
+    player.Stop();
+    EXPECT_FALSE(esp_timer_host_fire("led_animator"));
+}
@@ -0,0 +1,5 @@
+#include "host_test.h"
+
+int main() {
+    return RunHostTests();
+}
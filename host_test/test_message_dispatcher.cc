@@ -0,0 +1,118 @@
+#include "host_test.h"
+#include "message_dispatcher.h"
+
+#include <string>
+
+static_assert(MessageKey("tts") == FnvHash("tts"), "type-only key is the type hash");
+static_assert(MessageKey("tts", "start") == FnvHash("tts.start"), "type+state key hashes \"type.state\"");
+static_assert(MessageKey("tts", "start") != MessageKey("tts", "stop"), "state is part of the key");
+static_assert(MessageKey("tts", "start") != MessageKey("tts"), "type+state differs from type");
+
+TEST(HashMatchesFnv1a) {
+    // FNV-1a 的标准测试向量
+    EXPECT_EQ(FnvHash(""), 2166136261u);
+    EXPECT_EQ(FnvHash("a"), 0xe40c292cu);
+    EXPECT_EQ(FnvHash("foobar"), 0xbf9cf968u);
+}
+
+TEST(DispatchByTypeAndState) {
+    MessageDispatcher dispatcher;
+    std::string calls;
+    dispatcher.Register("tts", "start", [&calls](const IncomingMessage& message) { calls += "start;"; });
+    dispatcher.Register("tts", "stop", [&calls](const IncomingMessage& message) { calls += "stop;"; });
+    dispatcher.Register("tts", [&calls](const IncomingMessage& message) {
+        calls += std::string("tts:") + (message.state ? message.state : "") + ";";
+    });
+    dispatcher.Register("stt", [&calls](const IncomingMessage& message) { calls += std::string("stt:") + message.text + ";"; });
+
+    IncomingMessage message;
+    message.type = "tts";
+    message.state = "start";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+    message.state = "stop";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+    // 没有专门处理函数的 state 回退到只按 type 注册的处理函数
+    message.state = "sentence_start";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+    message.state = nullptr;
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+
+    message = IncomingMessage();
+    message.type = "stt";
+    message.text = "hello";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+    EXPECT_STREQ(calls.c_str(), "start;stop;tts:sentence_start;tts:;stt:hello;");
+}
+
+TEST(UnhandledMessages) {
+    MessageDispatcher dispatcher;
+    int calls = 0;
+    dispatcher.Register("tts", "start", [&calls](const IncomingMessage& message) { calls++; });
+
+    IncomingMessage message;
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchUnhandled);
+    message.type = "llm";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchUnhandled);
+    // 只注册了 type + state 时，缺少 state 或 state 不同都不匹配
+    message.type = "tts";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchUnhandled);
+    message.state = "stop";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchUnhandled);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(JsonHandlerNeedsFullParse) {
+    MessageDispatcher dispatcher;
+    const cJSON* received = nullptr;
+    dispatcher.RegisterJson("iot", [&received](const cJSON* root) { received = root; });
+
+    IncomingMessage message;
+    message.type = "iot";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchNeedsJson);
+    EXPECT_TRUE(received == nullptr);
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "type", "iot");
+    EXPECT_TRUE(dispatcher.Dispatch(root));
+    EXPECT_TRUE(received == root);
+    cJSON_Delete(root);
+}
+
+TEST(DispatchCjsonFillsCommonFields) {
+    MessageDispatcher dispatcher;
+    std::string text, emotion, session_id;
+    dispatcher.Register("llm", [&](const IncomingMessage& message) {
+        text = message.text ? message.text : "";
+        emotion = message.emotion ? message.emotion : "";
+        session_id = message.session_id ? message.session_id : "";
+    });
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "type", "llm");
+    cJSON_AddStringToObject(root, "text", "hi");
+    cJSON_AddStringToObject(root, "emotion", "happy");
+    cJSON_AddStringToObject(root, "session_id", "abc");
+    EXPECT_TRUE(dispatcher.Dispatch(root));
+    EXPECT_STREQ(text.c_str(), "hi");
+    EXPECT_STREQ(emotion.c_str(), "happy");
+    EXPECT_STREQ(session_id.c_str(), "abc");
+    cJSON_Delete(root);
+
+    // type 不是字符串时不分发
+    root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "type", 1);
+    EXPECT_FALSE(dispatcher.Dispatch(root));
+    cJSON_Delete(root);
+}
+
+TEST(ReRegisterReplacesHandler) {
+    MessageDispatcher dispatcher;
+    int first = 0, second = 0;
+    dispatcher.Register("goodbye", [&first](const IncomingMessage& message) { first++; });
+    dispatcher.Register("goodbye", [&second](const IncomingMessage& message) { second++; });
+    IncomingMessage message;
+    message.type = "goodbye";
+    EXPECT_EQ(dispatcher.Dispatch(message), kDispatchHandled);
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(second, 1);
+}
@@ -0,0 +1,140 @@
+#include "host_test.h"
+#include "mono_page_frame.h"
+
+#include <vector>
+
+#define WIDTH 128
+#define HEIGHT 64
+
+// 按 LVGL I1 格式生成一个区域，lit(x, y) 为 true 的像素位为 0（点亮）
+template <typename Lit>
+static std::vector<uint8_t> MakeArea(int x1, int y1, int x2, int y2, uint32_t stride, Lit lit) {
+    std::vector<uint8_t> bits(stride * (y2 - y1 + 1), 0xff);
+    for (int y = y1; y <= y2; y++) {
+        for (int x = x1; x <= x2; x++) {
+            int i = x - x1;
+            if (lit(x, y)) {
+                bits[(y - y1) * stride + (i >> 3)] &= ~(0x80 >> (i & 7));
+            }
+        }
+    }
+    return bits;
+}
+
+static uint32_t StrideOf(int x1, int x2) {
+    return (x2 - x1 + 1 + 7) / 8;
+}
+
+static void FoldArea(MonoPageFrame& frame, int x1, int y1, int x2, int y2, bool (*lit)(int, int)) {
+    uint32_t stride = StrideOf(x1, x2);
+    auto bits = MakeArea(x1, y1, x2, y2, stride, lit);
+    frame.Fold(x1, y1, x2, y2, bits.data(), stride);
+}
+
+static int DirtyPages(MonoPageFrame& frame) {
+    int count = 0, x1, x2;
+    for (int i = 0; i < frame.pages(); i++) {
+        if (frame.TakeDirtyRange(i, x1, x2)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(NewFrameIsBlankAndClean) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    EXPECT_TRUE(frame.valid());
+    EXPECT_EQ((int)frame.size(), WIDTH * HEIGHT / 8);
+    EXPECT_EQ(frame.pages(), HEIGHT / 8);
+    for (size_t i = 0; i < frame.size(); i++) {
+        EXPECT_EQ(frame.data()[i], 0);
+    }
+    EXPECT_EQ(DirtyPages(frame), 0);
+}
+
+TEST(FullScreenMarksEveryPage) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    FoldArea(frame, 0, 0, WIDTH - 1, HEIGHT - 1, [](int, int) { return true; });
+    for (size_t i = 0; i < frame.size(); i++) {
+        EXPECT_EQ(frame.data()[i], 0xff);
+    }
+    int x1, x2;
+    for (int i = 0; i < frame.pages(); i++) {
+        EXPECT_TRUE(frame.TakeDirtyRange(i, x1, x2));
+        EXPECT_EQ(x1, 0);
+        EXPECT_EQ(x2, WIDTH - 1);
+        EXPECT_FALSE(frame.TakeDirtyRange(i, x1, x2));
+    }
+}
+
+// 重新渲染相同内容不产生任何需要发送的数据
+TEST(UnchangedContentIsNotDirty) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    auto pattern = [](int x, int y) { return (x + y) % 3 == 0; };
+    FoldArea(frame, 0, 0, WIDTH - 1, HEIGHT - 1, pattern);
+    DirtyPages(frame);
+    FoldArea(frame, 0, 0, WIDTH - 1, HEIGHT - 1, pattern);
+    EXPECT_EQ(DirtyPages(frame), 0);
+}
+
+// 每字节纵向 8 行，低位在上
+TEST(SinglePixelMapsToPageBit) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    FoldArea(frame, 0, 8, WIDTH - 1, 15, [](int x, int y) { return x == 5 && y == 10; });
+    EXPECT_EQ(frame.page(1)[5], 1 << 2);
+    int x1, x2;
+    EXPECT_FALSE(frame.TakeDirtyRange(0, x1, x2));
+    EXPECT_TRUE(frame.TakeDirtyRange(1, x1, x2));
+    EXPECT_EQ(x1, 5);
+    EXPECT_EQ(x2, 5);
+    EXPECT_EQ(DirtyPages(frame), 0);
+
+    // 熄灭同一个像素也要发送
+    FoldArea(frame, 5, 10, 5, 10, [](int, int) { return false; });
+    EXPECT_EQ(frame.page(1)[5], 0);
+    EXPECT_TRUE(frame.TakeDirtyRange(1, x1, x2));
+    EXPECT_EQ(x1, 5);
+    EXPECT_EQ(x2, 5);
+}
+
+// 区域不从字节边界开始、每行带填充时按区域内的相对坐标取位
+TEST(UnalignedAreaWithPaddedStride) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    auto lit = [](int x, int y) { return x == 3 || x == 12 || y == 20; };
+    uint32_t stride = 4;
+    auto bits = MakeArea(3, 17, 12, 22, stride, lit);
+    frame.Fold(3, 17, 12, 22, bits.data(), stride);
+    for (int x = 0; x < WIDTH; x++) {
+        for (int y = 16; y < 24; y++) {
+            bool expected = x >= 3 && x <= 12 && y >= 17 && y <= 22 && lit(x, y);
+            bool on = frame.page(2)[x] & (1 << (y % 8));
+            EXPECT_EQ(on, expected);
+        }
+    }
+    int x1, x2;
+    EXPECT_TRUE(frame.TakeDirtyRange(2, x1, x2));
+    EXPECT_EQ(x1, 3);
+    EXPECT_EQ(x2, 12);
+}
+
+// 一帧分多次 flush 时，同一页的变化范围合并
+TEST(PartialFlushesMergeRanges) {
+    MonoPageFrame frame(WIDTH, HEIGHT);
+    FoldArea(frame, 0, 0, 31, 7, [](int x, int y) { return x == 2; });
+    FoldArea(frame, 96, 0, 127, 7, [](int x, int y) { return x == 100; });
+    int x1, x2;
+    EXPECT_TRUE(frame.TakeDirtyRange(0, x1, x2));
+    EXPECT_EQ(x1, 2);
+    EXPECT_EQ(x2, 100);
+    EXPECT_EQ(DirtyPages(frame), 0);
+}
+
+// 128x32 屏只有 4 页
+TEST(SmallPanelPages) {
+    MonoPageFrame frame(128, 32);
+    EXPECT_EQ(frame.pages(), 4);
+    FoldArea(frame, 0, 24, 127, 31, [](int x, int y) { return y == 31; });
+    int x1, x2;
+    EXPECT_TRUE(frame.TakeDirtyRange(3, x1, x2));
+    EXPECT_EQ(frame.page(3)[0], 0x80);
+}
@@ -0,0 +1,124 @@
+#include "host_test.h"
+#include "output_gain.h"
+
+#include <cmath>
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+TEST(VolumeFactorEndpoints) {
+    EXPECT_EQ(VolumeToFactor(0), 0);
+    EXPECT_EQ(VolumeToFactor(100), 65536);
+    EXPECT_EQ(VolumeToFactor(50), 16384);
+}
+
+TEST(VolumeFactorMatchesCurve) {
+    for (int volume = 0; volume <= 100; volume++) {
+        int32_t expected = static_cast<int32_t>(pow(double(volume) / 100.0, 2) * 65536);
+        EXPECT_EQ(VolumeToFactor(volume), expected);
+    }
+}
+
+TEST(VolumeFactorMonotonic) {
+    for (int volume = 1; volume <= 100; volume++) {
+        EXPECT_TRUE(VolumeToFactor(volume) > VolumeToFactor(volume - 1));
+    }
+}
+
+TEST(VolumeFactorClampsOutOfRange) {
+    EXPECT_EQ(VolumeToFactor(-5), 0);
+    EXPECT_EQ(VolumeToFactor(150), 65536);
+}
+
+// NoAudioCodec 直接用 32 位乘法，最大增益下满幅采样也不能溢出
+TEST(VolumeFactorFitsInt32) {
+    int64_t max_product = int64_t(INT16_MIN) * VolumeToFactor(100);
+    EXPECT_TRUE(max_product >= INT32_MIN);
+    EXPECT_TRUE(int64_t(INT16_MAX) * VolumeToFactor(100) <= INT32_MAX);
+}
+
+static std::vector<int16_t> Sine(int sample_rate, int frequency, int samples) {
+    std::vector<int16_t> data(samples);
+    for (int i = 0; i < samples; i++) {
+        data[i] = static_cast<int16_t>(32767 * sin(2 * M_PI * frequency * i / sample_rate));
+    }
+    return data;
+}
+
+static int MaxStep(const std::vector<int16_t>& data) {
+    int max_step = 0;
+    for (size_t i = 1; i < data.size(); i++) {
+        max_step = std::max(max_step, abs(data[i] - data[i - 1]));
+    }
+    return max_step;
+}
+
+TEST(GainRampStepCoversRampTime) {
+    int32_t step = GainRampStep(16000, 1);
+    int ramp_samples = 16000 / 1000 * OUTPUT_GAIN_RAMP_MS;
+    EXPECT_EQ(step, OUTPUT_GAIN_UNITY / ramp_samples);
+    EXPECT_EQ(GainRampStep(24000, 2), OUTPUT_GAIN_UNITY / (24000 / 1000 * OUTPUT_GAIN_RAMP_MS * 2));
+    EXPECT_EQ(GainRampStep(0, 1), OUTPUT_GAIN_UNITY);
+}
+
+TEST(UnityGainLeavesSamplesUntouched) {
+    auto data = Sine(16000, 440, 480);
+    auto original = data;
+    auto gain = ApplyGainRamp(data.data(), data.size(), OUTPUT_GAIN_UNITY, OUTPUT_GAIN_UNITY, GainRampStep(16000, 1));
+    EXPECT_EQ(gain, OUTPUT_GAIN_UNITY);
+    EXPECT_TRUE(data == original);
+}
+
+// 在一帧中间静音，输出的相邻采样差不应超过原始信号本身的最大斜率
+// 直接截断（增益阶跃）会在静音点产生接近满幅的跳变
+TEST(MuteMidFrameHasNoDiscontinuity) {
+    const int sample_rate = 16000;
+    auto data = Sine(sample_rate, 200, 960);
+    int signal_step = MaxStep(data);
+    int32_t step = GainRampStep(sample_rate, 1);
+
+    // 前半帧保持原增益，在正弦波峰附近开始静音
+    size_t mute_at = 500;
+    int32_t gain = ApplyGainRamp(data.data(), mute_at, OUTPUT_GAIN_UNITY, OUTPUT_GAIN_UNITY, step);
+    gain = ApplyGainRamp(data.data() + mute_at, data.size() - mute_at, gain, 0, step);
+    EXPECT_EQ(gain, 0);
+    EXPECT_TRUE(MaxStep(data) <= signal_step);
+
+    // 过渡在 OUTPUT_GAIN_RAMP_MS 内完成，之后全部是静音
+    size_t ramp_samples = sample_rate / 1000 * OUTPUT_GAIN_RAMP_MS;
+    for (size_t i = mute_at + ramp_samples; i < data.size(); i++) {
+        EXPECT_EQ(data[i], 0);
+    }
+
+    auto hard_cut = Sine(sample_rate, 200, 960);
+    std::fill(hard_cut.begin() + mute_at, hard_cut.end(), 0);
+    EXPECT_TRUE(MaxStep(hard_cut) > 4 * signal_step);
+}
+
+// 打断播放后增益从 0 开始，下一段音频淡入而不是从波峰直接开始
+TEST(FadeInAfterFlushHasNoDiscontinuity) {
+    const int sample_rate = 24000;
+    auto data = Sine(sample_rate, 1000, 1440);
+    // 从波峰开始的信号，直接输出时第一个采样相对静音就是满幅跳变
+    std::rotate(data.begin(), data.begin() + 6, data.end());
+    int signal_step = MaxStep(data);
+    int32_t gain = ApplyGainRamp(data.data(), data.size(), 0, OUTPUT_GAIN_UNITY, GainRampStep(sample_rate, 1));
+    EXPECT_EQ(gain, OUTPUT_GAIN_UNITY);
+    EXPECT_TRUE(abs(data[0]) <= signal_step);
+    EXPECT_TRUE(MaxStep(data) <= signal_step);
+}
+
+// 跨多帧调用时增益连续，帧边界处不会重新开始过渡
+TEST(RampContinuesAcrossFrames) {
+    const int sample_rate = 16000;
+    int32_t step = GainRampStep(sample_rate, 1);
+    auto whole = Sine(sample_rate, 300, 320);
+    auto split = whole;
+    ApplyGainRamp(whole.data(), whole.size(), OUTPUT_GAIN_UNITY, 0, step);
+    int32_t gain = OUTPUT_GAIN_UNITY;
+    for (size_t offset = 0; offset < split.size(); offset += 32) {
+        gain = ApplyGainRamp(split.data() + offset, 32, gain, 0, step);
+    }
+    EXPECT_TRUE(whole == split);
+}
@@ -0,0 +1,129 @@
+#include "host_test.h"
+#include "wav_file.h"
+
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+static std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return data;
+    }
+    uint8_t buffer[256];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(file);
+    return data;
+}
+
+static std::string TempPath(const char* name) {
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/xiaozhi_" + name;
+}
+
+TEST(HeaderRoundTrip) {
+    uint8_t wav[WAV_HEADER_SIZE + 8] = {};
+    WavFile::MakeHeader(wav, 16000, 1, 8);
+    WavInfo info;
+    EXPECT_TRUE(WavFile::Parse(wav, sizeof(wav), info));
+    EXPECT_EQ(info.format, 1);
+    EXPECT_EQ(info.channels, 1);
+    EXPECT_EQ(info.sample_rate, 16000u);
+    EXPECT_EQ(info.bits_per_sample, 16);
+    EXPECT_EQ(info.data_size, 8u);
+    EXPECT_TRUE(info.data == wav + WAV_HEADER_SIZE);
+}
+
+TEST(ParseSkipsUnknownChunks) {
+    std::vector<uint8_t> wav(WAV_HEADER_SIZE);
+    WavFile::MakeHeader(wav.data(), 24000, 2, 4);
+    // 在 fmt 和 data 之间插入一个奇数长度的 LIST 块，需要按偶数对齐跳过
+    std::vector<uint8_t> list = { 'L', 'I', 'S', 'T', 3, 0, 0, 0, 'a', 'b', 'c', 0 };
+    wav.insert(wav.begin() + 36, list.begin(), list.end());
+    wav.insert(wav.end(), { 1, 2, 3, 4 });
+    WavInfo info;
+    EXPECT_TRUE(WavFile::Parse(wav.data(), wav.size(), info));
+    EXPECT_EQ(info.channels, 2);
+    EXPECT_EQ(info.sample_rate, 24000u);
+    EXPECT_EQ(info.data_size, 4u);
+    EXPECT_EQ(info.data[0], 1);
+}
+
+TEST(ParseTruncatedData) {
+    uint8_t wav[WAV_HEADER_SIZE + 4] = {};
+    WavFile::MakeHeader(wav, 16000, 1, 1000);
+    WavInfo info;
+    EXPECT_TRUE(WavFile::Parse(wav, sizeof(wav), info));
+    EXPECT_EQ(info.data_size, 4u);
+}
+
+TEST(ParseRejectsInvalidInput) {
+    WavInfo info;
+    uint8_t riff[12] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E' };
+    EXPECT_FALSE(WavFile::Parse(riff, sizeof(riff), info));
+    uint8_t wav[WAV_HEADER_SIZE] = {};
+    WavFile::MakeHeader(wav, 16000, 1, 0);
+    EXPECT_FALSE(WavFile::Parse(wav, 8, info));
+    wav[0] = 'X';
+    EXPECT_FALSE(WavFile::Parse(wav, sizeof(wav), info));
+    // 块长度远超文件大小时不能越界
+    uint8_t huge[20] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'J', 'U', 'N', 'K', 0xFF, 0xFF, 0xFF, 0xFF };
+    EXPECT_FALSE(WavFile::Parse(huge, sizeof(huge), info));
+}
+
+TEST(WriterProducesPlayableFile) {
+    auto path = TempPath("writer.wav");
+    std::vector<int16_t> pcm(24000 + 100);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = int16_t(i * 7);
+    }
+
+    WavWriter writer;
+    EXPECT_TRUE(writer.Open(path.c_str(), 24000, 1));
+    for (size_t offset = 0; offset < pcm.size(); offset += 240) {
+        int samples = std::min<size_t>(240, pcm.size() - offset);
+        writer.Write(pcm.data() + offset, samples);
+    }
+
+    // 写满一秒后文件头已经回写，未关闭的文件也能解析出已同步的数据
+    auto partial = ReadFile(path);
+    WavInfo info;
+    EXPECT_TRUE(WavFile::Parse(partial.data(), partial.size(), info));
+    EXPECT_TRUE(info.data_size >= 24000 * sizeof(int16_t));
+
+    writer.Close();
+    auto wav = ReadFile(path);
+    EXPECT_TRUE(WavFile::Parse(wav.data(), wav.size(), info));
+    EXPECT_EQ(info.sample_rate, 24000u);
+    EXPECT_EQ(info.data_size, pcm.size() * sizeof(int16_t));
+    EXPECT_TRUE(memcmp(info.data, pcm.data(), info.data_size) == 0);
+    remove(path.c_str());
+}
+
+TEST(WriterStopsAtLimit) {
+    auto path = TempPath("limit.wav");
+    std::vector<int16_t> pcm(100, 1000);
+    WavWriter writer;
+    EXPECT_TRUE(writer.Open(path.c_str(), 16000, 1, 151));
+    writer.Write(pcm.data(), pcm.size());
+    writer.Write(pcm.data(), pcm.size());
+    EXPECT_EQ(writer.data_size(), 150u);
+    writer.Close();
+    auto wav = ReadFile(path);
+    EXPECT_EQ(wav.size(), WAV_HEADER_SIZE + 150u);
+    remove(path.c_str());
+}
+
+TEST(WriterOpenFailure) {
+    WavWriter writer;
+    EXPECT_FALSE(writer.Open("/nonexistent_dir/output.wav", 16000, 1));
+    EXPECT_FALSE(writer.is_open());
+    int16_t sample = 0;
+    writer.Write(&sample, 1);
+    EXPECT_EQ(writer.data_size(), 0u);
+}
@@ -1,6 +1,8 @@
 #include "application.h"
 #include "board.h"
+#include "power_manager.h"
 #include "display.h"
+#include "render_benchmark.h"
 #include "system_info.h"
 #include "ml307_ssl_transport.h"
 #include "audio_codec.h"
@@ -8,9 +10,11 @@
 #include "websocket_protocol.h"
 #include "font_awesome_symbols.h"
 #include "iot/thing_manager.h"
+#include "latency_tracer.h"
 #include "assets/lang_config.h"
 
 #include <cstring>
+#include <future>
 #include <esp_log.h>
 #include <cJSON.h>
 #include <driver/gpio.h>
@@ -18,24 +22,12 @@
 
 #define TAG "Application"
 
-
-static const char* const STATE_STRINGS[] = {
-    "unknown",
-    "starting",
-    "configuring",
-    "idle",
-    "connecting",
-    "listening",
-    "speaking",
-    "upgrading",
-    "activating",
-    "fatal_error",
-    "invalid_state"
-};
-
 Application::Application() {
     event_group_ = xEventGroupCreate();
     background_task_ = new BackgroundTask(4096 * 8);
+    state_machine_.OnStateChanged([this](DeviceState previous, DeviceState current) {
+        OnDeviceStateChanged(previous, current);
+    });
 
     esp_timer_create_args_t clock_timer_args = {
         .callback = [](void* arg) {
@@ -85,17 +77,27 @@ void Application::CheckNewVersion() {
         if (ota_.HasNewVersion()) {
             Alert(Lang::Strings::OTA_UPGRADE, Lang::Strings::UPGRADING, "happy", Lang::Sounds::P3_UPGRADE);
             // Wait for the chat state to be idle
-            do {
-                vTaskDelay(pdMS_TO_TICKS(3000));
-            } while (GetDeviceState() != kDeviceStateIdle);
+            // 轮询到空闲后用户仍可能在主循环处理升级事件前唤醒设备，此时升级事件被拒绝，需要重新等待
+            while (true) {
+                do {
+                    vTaskDelay(pdMS_TO_TICKS(3000));
+                } while (GetDeviceState() != kDeviceStateIdle);
+
+                std::promise<bool> accepted;
+                Schedule([this, &accepted]() {
+                    accepted.set_value(HandleEvent(kDeviceEventUpgrade));
+                });
+                if (accepted.get_future().get()) {
+                    break;
+                }
+                ESP_LOGW(TAG, "Device is busy, wait for idle again before upgrading");
+            }
 
             // Use main task to do the upgrade, not cancelable
             Schedule([this, display]() {
-                SetDeviceState(kDeviceStateUpgrading);
-                
-                display->SetIcon(FONT_AWESOME_DOWNLOAD);
+                display->PostIcon(FONT_AWESOME_DOWNLOAD);
                 std::string message = std::string(Lang::Strings::NEW_VERSION) + ota_.GetFirmwareVersion();
-                display->SetChatMessage("system", message.c_str());
+                display->PostChatMessage("system", message.c_str());
 
                 auto& board = Board::GetInstance();
                 board.SetPowerSaveMode(false);
@@ -118,11 +120,11 @@ void Application::CheckNewVersion() {
                 ota_.StartUpgrade([display](int progress, size_t speed) {
                     char buffer[64];
                     snprintf(buffer, sizeof(buffer), "%d%% %zuKB/s", progress, speed / 1024);
-                    display->SetChatMessage("system", buffer);
+                    display->PostChatMessage("system", buffer);
                 });
 
                 // If upgrade success, the device will reboot and never reach here
-                display->SetStatus(Lang::Strings::UPGRADE_FAILED);
+                display->PostStatus(Lang::Strings::UPGRADE_FAILED);
                 ESP_LOGI(TAG, "Firmware upgrade failed...");
                 vTaskDelay(pdMS_TO_TICKS(3000));
                 Reboot();
@@ -138,21 +140,22 @@ void Application::CheckNewVersion() {
     
         if (ota_.HasActivationCode()) {
             // Activation code is valid
-            SetDeviceState(kDeviceStateActivating);
+            PostEvent(kDeviceEventActivate);
             ShowActivationCode();
 
             // Check again in 60 seconds or until the device is idle
+            // The activate event is handled by the main loop, so wait before checking the state
             for (int i = 0; i < 60; ++i) {
-                if (device_state_ == kDeviceStateIdle) {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                if (GetDeviceState() == kDeviceStateIdle) {
                     break;
                 }
-                vTaskDelay(pdMS_TO_TICKS(1000));
             }
             continue;
         }
 
-        SetDeviceState(kDeviceStateIdle);
-        display->SetChatMessage("system", "");
+        PostEvent(kDeviceEventReady);
+        display->PostChatMessage("system", "");
 
         // Exit the loop if upgrade or idle
         break;
@@ -197,9 +200,9 @@ void Application::ShowActivationCode() {
 void Application::Alert(const char* status, const char* message, const char* emotion, const std::string_view& sound) {
     ESP_LOGW(TAG, "Alert %s: %s [%s]", status, message, emotion);
     auto display = Board::GetInstance().GetDisplay();
-    display->SetStatus(status);
-    display->SetEmotion(emotion);
-    display->SetChatMessage("system", message);
+    display->PostStatus(status);
+    display->PostEmotion(emotion);
+    display->PostChatMessage("system", message);
     if (!sound.empty()) {
         PlayLocalFile(sound.data(), sound.size());
     }
@@ -227,7 +230,7 @@ void Application::PlayLocalFile(const char* data, size_t size) {
 
 void Application::ToggleChatState() {
     Schedule([this]() {
-        if (device_state_ == kDeviceStateActivating) {
+        if (GetDeviceState() == kDeviceStateActivating) {
             Reboot();
             return;
         }
@@ -237,19 +240,19 @@ void Application::ToggleChatState() {
             return;
         }
 
-        if (device_state_ == kDeviceStateIdle) {
-            SetDeviceState(kDeviceStateConnecting);
+        if (GetDeviceState() == kDeviceStateIdle) {
+            HandleEvent(kDeviceEventConnect);
             if (!protocol_->OpenAudioChannel()) {
-                SetDeviceState(kDeviceStateIdle);
+                HandleEvent(kDeviceEventStop);
                 return;
             }
 
             keep_listening_ = true;
-            protocol_->SendStartListening(kListeningModeAutoStop);
-            SetDeviceState(kDeviceStateListening);
-        } else if (device_state_ == kDeviceStateSpeaking) {
+            protocol_->SendStartListening(realtime_chat_enabled_ ? kListeningModeAlwaysOn : kListeningModeAutoStop);
+            HandleEvent(kDeviceEventListen);
+        } else if (GetDeviceState() == kDeviceStateSpeaking) {
             AbortSpeaking(kAbortReasonNone);
-        } else if (device_state_ == kDeviceStateListening) {
+        } else if (GetDeviceState() == kDeviceStateListening) {
             protocol_->CloseAudioChannel();
         }
     });
@@ -257,7 +260,7 @@ void Application::ToggleChatState() {
 
 void Application::StartListening() {
     Schedule([this]() {
-        if (device_state_ == kDeviceStateActivating) {
+        if (GetDeviceState() == kDeviceStateActivating) {
             Reboot();
             return;
         }
@@ -268,41 +271,43 @@ void Application::StartListening() {
         }
         
         keep_listening_ = false;
-        if (device_state_ == kDeviceStateIdle) {
+        if (GetDeviceState() == kDeviceStateIdle) {
             if (!protocol_->IsAudioChannelOpened()) {
-                SetDeviceState(kDeviceStateConnecting);
+                HandleEvent(kDeviceEventConnect);
                 if (!protocol_->OpenAudioChannel()) {
-                    SetDeviceState(kDeviceStateIdle);
+                    HandleEvent(kDeviceEventStop);
                     return;
                 }
             }
             protocol_->SendStartListening(kListeningModeManualStop);
-            SetDeviceState(kDeviceStateListening);
-        } else if (device_state_ == kDeviceStateSpeaking) {
+            HandleEvent(kDeviceEventListen);
+        } else if (GetDeviceState() == kDeviceStateSpeaking) {
+            // AbortSpeaking 已清空输出缓冲区，无需等待扬声器播放完
             AbortSpeaking(kAbortReasonNone);
             protocol_->SendStartListening(kListeningModeManualStop);
-            // FIXME: Wait for the speaker to empty the buffer
-            vTaskDelay(pdMS_TO_TICKS(120));
-            SetDeviceState(kDeviceStateListening);
+            HandleEvent(kDeviceEventListen);
         }
     });
 }
 
 void Application::StopListening() {
     Schedule([this]() {
-        if (device_state_ == kDeviceStateListening) {
+        if (GetDeviceState() == kDeviceStateListening) {
             protocol_->SendStopListening();
-            SetDeviceState(kDeviceStateIdle);
+            HandleEvent(kDeviceEventStop);
         }
     });
 }
 
 void Application::Start() {
     auto& board = Board::GetInstance();
-    SetDeviceState(kDeviceStateStarting);
+    HandleEvent(kDeviceEventStart);
 
     /* Setup the display */
     auto display = board.GetDisplay();
+#if CONFIG_USE_DISPLAY_RENDER_BENCHMARK
+    RunRenderBenchmark(display);
+#endif
 
     /* Setup the audio codec */
     auto codec = board.GetAudioCodec();
@@ -346,7 +351,7 @@ void Application::Start() {
     board.StartNetwork();
 
     // Initialize the protocol
-    display->SetStatus(Lang::Strings::LOADING_PROTOCOL);
+    display->PostStatus(Lang::Strings::LOADING_PROTOCOL);
 #ifdef CONFIG_CONNECTION_TYPE_WEBSOCKET
     protocol_ = std::make_unique<WebsocketProtocol>();
 #else
@@ -356,12 +361,14 @@ void Application::Start() {
         Alert(Lang::Strings::ERROR, message.c_str(), "sad");
     });
     protocol_->OnIncomingAudio([this](std::vector<uint8_t>&& data) {
+        LATENCY_TRACE(kTraceAudioReceived);
         std::lock_guard<std::mutex> lock(mutex_);
-        if (device_state_ == kDeviceStateSpeaking) {
+        if (GetDeviceState() == kDeviceStateSpeaking) {
             audio_decode_queue_.emplace_back(std::move(data));
         }
     });
     protocol_->OnAudioChannelOpened([this, codec, &board]() {
+        PowerManager::GetInstance().WakeUp();
         board.SetPowerSaveMode(false);
         if (protocol_->server_sample_rate() != codec->output_sample_rate()) {
             ESP_LOGW(TAG, "Server sample rate %d does not match device output sample rate %d, resampling may cause distortion",
@@ -377,66 +384,69 @@ void Application::Start() {
         board.SetPowerSaveMode(true);
         Schedule([this]() {
             auto display = Board::GetInstance().GetDisplay();
-            display->SetChatMessage("system", "");
-            SetDeviceState(kDeviceStateIdle);
+            display->PostChatMessage("system", "");
+            HandleEvent(kDeviceEventStop);
         });
     });
-    protocol_->OnIncomingJson([this, display](const cJSON* root) {
-        // Parse JSON data
-        auto type = cJSON_GetObjectItem(root, "type");
-        if (strcmp(type->valuestring, "tts") == 0) {
-            auto state = cJSON_GetObjectItem(root, "state");
-            if (strcmp(state->valuestring, "start") == 0) {
-                Schedule([this]() {
-                    aborted_ = false;
-                    if (device_state_ == kDeviceStateIdle || device_state_ == kDeviceStateListening) {
-                        SetDeviceState(kDeviceStateSpeaking);
-                    }
-                });
-            } else if (strcmp(state->valuestring, "stop") == 0) {
-                Schedule([this]() {
-                    if (device_state_ == kDeviceStateSpeaking) {
-                        background_task_->WaitForCompletion();
+    protocol_->OnIncomingMessage("tts", "start", [this](const IncomingMessage& message) {
+        LATENCY_TRACE(kTraceTtsStart);
+        Schedule([this]() {
+            aborted_ = false;
+            if (GetDeviceState() == kDeviceStateIdle || GetDeviceState() == kDeviceStateListening) {
+                HandleEvent(kDeviceEventSpeak);
+            }
+        });
+    });
+    protocol_->OnIncomingMessage("tts", "stop", [this](const IncomingMessage& message) {
+        LATENCY_TRACE(kTraceTtsStop);
+        Schedule([this]() {
+            if (GetDeviceState() == kDeviceStateSpeaking) {
+                if (realtime_chat_enabled_ && keep_listening_) {
+                    // 上行音频一直在发送，剩余的 TTS 音频继续播放完
+                    HandleEvent(kDeviceEventListen);
+                    return;
+                }
+                // 等已排队的解码任务执行完再切换状态：完成回调排在这些任务之后，再回到主循环处理，主循环不阻塞
+                background_task_->Schedule([this]() {
+                    Schedule([this]() {
+                        if (GetDeviceState() != kDeviceStateSpeaking) {
+                            return;
+                        }
                         if (keep_listening_) {
                             protocol_->SendStartListening(kListeningModeAutoStop);
-                            SetDeviceState(kDeviceStateListening);
+                            HandleEvent(kDeviceEventListen);
                         } else {
-                            SetDeviceState(kDeviceStateIdle);
+                            HandleEvent(kDeviceEventStop);
                         }
-                    }
-                });
-            } else if (strcmp(state->valuestring, "sentence_start") == 0) {
-                auto text = cJSON_GetObjectItem(root, "text");
-                if (text != NULL) {
-                    ESP_LOGI(TAG, "<< %s", text->valuestring);
-                    Schedule([this, display, message = std::string(text->valuestring)]() {
-                        display->SetChatMessage("assistant", message.c_str());
                     });
-                }
-            }
-        } else if (strcmp(type->valuestring, "stt") == 0) {
-            auto text = cJSON_GetObjectItem(root, "text");
-            if (text != NULL) {
-                ESP_LOGI(TAG, ">> %s", text->valuestring);
-                Schedule([this, display, message = std::string(text->valuestring)]() {
-                    display->SetChatMessage("user", message.c_str());
                 });
             }
-        } else if (strcmp(type->valuestring, "llm") == 0) {
-            auto emotion = cJSON_GetObjectItem(root, "emotion");
-            if (emotion != NULL) {
-                Schedule([this, display, emotion_str = std::string(emotion->valuestring)]() {
-                    display->SetEmotion(emotion_str.c_str());
-                });
-            }
-        } else if (strcmp(type->valuestring, "iot") == 0) {
-            auto commands = cJSON_GetObjectItem(root, "commands");
-            if (commands != NULL) {
-                auto& thing_manager = iot::ThingManager::GetInstance();
-                for (int i = 0; i < cJSON_GetArraySize(commands); ++i) {
-                    auto command = cJSON_GetArrayItem(commands, i);
-                    thing_manager.Invoke(command);
-                }
+        });
+    });
+    protocol_->OnIncomingMessage("tts", "sentence_start", [display](const IncomingMessage& message) {
+        if (message.text != nullptr) {
+            ESP_LOGI(TAG, "<< %s", message.text);
+            display->PostChatMessage("assistant", message.text);
+        }
+    });
+    protocol_->OnIncomingMessage("stt", [display](const IncomingMessage& message) {
+        if (message.text != nullptr) {
+            ESP_LOGI(TAG, ">> %s", message.text);
+            display->PostChatMessage("user", message.text);
+        }
+    });
+    protocol_->OnIncomingMessage("llm", [display](const IncomingMessage& message) {
+        if (message.emotion != nullptr) {
+            display->PostEmotion(message.emotion);
+        }
+    });
+    protocol_->OnIncomingJson("iot", [](const cJSON* root) {
+        auto commands = cJSON_GetObjectItem(root, "commands");
+        if (commands != NULL) {
+            auto& thing_manager = iot::ThingManager::GetInstance();
+            for (int i = 0; i < cJSON_GetArraySize(commands); ++i) {
+                auto command = cJSON_GetArrayItem(commands, i);
+                thing_manager.Invoke(command);
             }
         }
     });
@@ -456,21 +466,33 @@ void Application::Start() {
 
 
 #if CONFIG_USE_AUDIO_PROCESSING
-    audio_processor_.Initialize(codec->input_channels(), codec->input_reference());
+#if CONFIG_USE_REALTIME_CHAT
+    realtime_chat_enabled_ = codec->input_reference();
+    if (!realtime_chat_enabled_) {
+        ESP_LOGW(TAG, "Realtime chat requires an input reference channel, disabled");
+    }
+#endif
+    audio_processor_.Initialize(codec->input_channels(), codec->input_reference(), realtime_chat_enabled_);
     audio_processor_.OnOutput([this](std::vector<int16_t>&& data) {
-        background_task_->Schedule([this, data = std::move(data)]() mutable {
-            opus_encoder_->Encode(std::move(data), [this](std::vector<uint8_t>&& opus) {
-                Schedule([this, opus = std::move(opus)]() {
-                    protocol_->SendAudio(opus);
-                });
-            });
+        background_task_->ScheduleCodec([this, data = std::move(data)]() mutable {
+            EncodeAudio(std::move(data));
         });
     });
 
     wake_word_detect_.Initialize(codec->input_channels(), codec->input_reference());
-    wake_word_detect_.OnVadStateChange([this](bool speaking) {
-        Schedule([this, speaking]() {
-            if (device_state_ == kDeviceStateListening) {
+    wake_word_detect_.OnVadStateChange([this, codec](bool speaking) {
+        Schedule([this, codec, speaking]() {
+#if CONFIG_USE_VAD_BARGE_IN
+            // 有回声参考时 VAD 不会被自己的播放声音触发，用户开口即可打断
+            if (speaking && GetDeviceState() == kDeviceStateSpeaking && codec->input_reference()) {
+                ESP_LOGI(TAG, "Voice detected while speaking, barge in");
+                AbortSpeaking(kAbortReasonNone);
+                protocol_->SendStartListening(realtime_chat_enabled_ ? kListeningModeAlwaysOn : kListeningModeAutoStop);
+                HandleEvent(kDeviceEventListen);
+                return;
+            }
+#endif
+            if (GetDeviceState() == kDeviceStateListening) {
                 if (speaking) {
                     voice_detected_ = true;
                 } else {
@@ -484,13 +506,13 @@ void Application::Start() {
 
     wake_word_detect_.OnWakeWordDetected([this](const std::string& wake_word) {
         Schedule([this, &wake_word]() {
-            if (device_state_ == kDeviceStateIdle) {
-                SetDeviceState(kDeviceStateConnecting);
+            if (GetDeviceState() == kDeviceStateIdle) {
+                HandleEvent(kDeviceEventConnect);
                 wake_word_detect_.EncodeWakeWordData();
 
                 if (!protocol_->OpenAudioChannel()) {
                     ESP_LOGE(TAG, "Failed to open audio channel");
-                    SetDeviceState(kDeviceStateIdle);
+                    HandleEvent(kDeviceEventStop);
                     wake_word_detect_.StartDetection();
                     return;
                 }
@@ -502,13 +524,16 @@ void Application::Start() {
                 }
                 // Set the chat state to wake word detected
                 protocol_->SendWakeWordDetected(wake_word);
+                if (realtime_chat_enabled_) {
+                    protocol_->SendStartListening(kListeningModeAlwaysOn);
+                }
                 ESP_LOGI(TAG, "Wake word detected: %s", wake_word.c_str());
                 keep_listening_ = true;
-                SetDeviceState(kDeviceStateListening);
-            } else if (device_state_ == kDeviceStateSpeaking) {
+                HandleEvent(kDeviceEventListen);
+            } else if (GetDeviceState() == kDeviceStateSpeaking) {
                 AbortSpeaking(kAbortReasonWakeWordDetected);
-            } else if (device_state_ == kDeviceStateActivating) {
-                SetDeviceState(kDeviceStateIdle);
+            } else if (GetDeviceState() == kDeviceStateActivating) {
+                HandleEvent(kDeviceEventReady);
             }
 
             // Resume detection
@@ -518,7 +543,36 @@ void Application::Start() {
     wake_word_detect_.StartDetection();
 #endif
 
-    SetDeviceState(kDeviceStateIdle);
+    // 唤醒词检测和 I2S 驱动都持有电源锁，睡眠前必须停掉，否则芯片无法进入浅睡眠
+    auto& power_manager = PowerManager::GetInstance();
+    power_manager.OnEnterSleep([this]() {
+        Schedule([this]() {
+            if (sleeping_ || GetDeviceState() != kDeviceStateIdle) {
+                return;
+            }
+            ESP_LOGI(TAG, "Enter sleep, audio input paused");
+            sleeping_ = true;
+#if CONFIG_USE_AUDIO_PROCESSING
+            wake_word_detect_.StopDetection();
+#endif
+            Board::GetInstance().GetAudioCodec()->EnableInput(false);
+        });
+    });
+    power_manager.OnExitSleep([this]() {
+        Schedule([this]() {
+            if (!sleeping_) {
+                return;
+            }
+            ESP_LOGI(TAG, "Exit sleep, audio input resumed");
+            sleeping_ = false;
+            Board::GetInstance().GetAudioCodec()->EnableInput(true);
+#if CONFIG_USE_AUDIO_PROCESSING
+            wake_word_detect_.StartDetection();
+#endif
+        });
+    });
+
+    PostEvent(kDeviceEventReady);
     esp_timer_start_periodic(clock_timer_handle_, 1000000);
 }
 
@@ -532,16 +586,35 @@ void Application::OnClockTimer() {
         int free_sram = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
         int min_free_sram = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
         ESP_LOGI(TAG, "Free internal: %u minimal internal: %u", free_sram, min_free_sram);
+        if (count % 60 == 0) {
+            // 转换统计在主循环的 HandleEvent 中更新，在主循环中读取和清零
+            Schedule([this]() {
+                state_machine_.LogMetrics();
+            });
+            auto display = Board::GetInstance().GetDisplay();
+            ESP_LOGI(TAG, "UI updates received: %lu applied: %lu",
+                display->updates_received(), display->updates_applied());
+            display->LogRenderStats();
+            PowerManager::GetInstance().LogReport();
+            LogEncodeStats();
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+            uint32_t frames = audio_level_frames_.exchange(0);
+            uint32_t analysis_us = audio_level_us_.exchange(0);
+            if (frames > 0) {
+                ESP_LOGI(TAG, "Audio level analysis: %lu frames, avg %lu us", frames, analysis_us / frames);
+            }
+#endif
+        }
 
         // If we have synchronized server time, set the status to clock "HH:MM" if the device is idle
         if (ota_.HasServerTime()) {
             Schedule([this]() {
-                if (device_state_ == kDeviceStateIdle) {
+                if (GetDeviceState() == kDeviceStateIdle) {
                     // Set status to clock "HH:MM"
                     time_t now = time(NULL);
                     char time_str[64];
                     strftime(time_str, sizeof(time_str), "%H:%M  ", localtime(&now));
-                    Board::GetInstance().GetDisplay()->SetStatus(time_str);
+                    Board::GetInstance().GetDisplay()->PostStatus(time_str);
                 }
             });
         }
@@ -584,9 +657,12 @@ void Application::MainLoop() {
 
 void Application::ResetDecoder() {
     std::lock_guard<std::mutex> lock(mutex_);
-    opus_decoder_->ResetState();
     audio_decode_queue_.clear();
     last_output_time_ = std::chrono::steady_clock::now();
+    // 在后台任务中重置，与已排队的解码任务串行执行，无需等待它们完成
+    background_task_->Schedule([this]() {
+        opus_decoder_->ResetState();
+    });
 }
 
 void Application::OutputAudio() {
@@ -597,7 +673,7 @@ void Application::OutputAudio() {
     std::unique_lock<std::mutex> lock(mutex_);
     if (audio_decode_queue_.empty()) {
         // Disable the output if there is no audio data for a long time
-        if (device_state_ == kDeviceStateIdle) {
+        if (GetDeviceState() == kDeviceStateIdle) {
             auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - last_output_time_).count();
             if (duration > max_silence_seconds) {
                 codec->EnableOutput(false);
@@ -606,7 +682,8 @@ void Application::OutputAudio() {
         return;
     }
 
-    if (device_state_ == kDeviceStateListening) {
+    // 实时对话模式下 TTS 结束后立即进入聆听，剩余音频仍需播放
+    if (GetDeviceState() == kDeviceStateListening && !realtime_chat_enabled_) {
         audio_decode_queue_.clear();
         return;
     }
@@ -616,8 +693,9 @@ void Application::OutputAudio() {
     audio_decode_queue_.pop_front();
     lock.unlock();
 
-    background_task_->Schedule([this, codec, opus = std::move(opus)]() mutable {
-        if (aborted_) {
+    uint32_t generation = decode_generation_;
+    background_task_->ScheduleCodec([this, codec, generation, opus = std::move(opus)]() mutable {
+        if (aborted_ || generation != decode_generation_) {
             return;
         }
 
@@ -625,6 +703,7 @@ void Application::OutputAudio() {
         if (!opus_decoder_->Decode(std::move(opus), pcm)) {
             return;
         }
+        LATENCY_TRACE(kTraceAudioDecoded);
 
         // Resample if the sample rate is different
         if (opus_decode_sample_rate_ != codec->output_sample_rate()) {
@@ -633,7 +712,15 @@ void Application::OutputAudio() {
             output_resampler_.Process(pcm.data(), pcm.size(), resampled.data());
             pcm = std::move(resampled);
         }
-        
+
+        // 解码期间可能已被打断
+        if (generation != decode_generation_) {
+            return;
+        }
+        LATENCY_TRACE(kTraceAudioOutput);
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+        UpdateAudioLevels(pcm.data(), pcm.size(), 1, codec->output_sample_rate(), true);
+#endif
         codec->OutputData(pcm);
     });
 }
@@ -644,6 +731,9 @@ void Application::InputAudio() {
     if (!codec->InputData(data)) {
         return;
     }
+    if (GetDeviceState() == kDeviceStateListening) {
+        LATENCY_TRACE(kTraceAudioCaptured);
+    }
 
     if (codec->input_sample_rate() != 16000) {
         if (codec->input_channels() == 2) {
@@ -668,7 +758,13 @@ void Application::InputAudio() {
             data = std::move(resampled);
         }
     }
-    
+
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+    if (GetDeviceState() == kDeviceStateListening) {
+        UpdateAudioLevels(data.data(), data.size(), codec->input_channels(), 16000, false);
+    }
+#endif
+
 #if CONFIG_USE_AUDIO_PROCESSING
     if (audio_processor_.IsRunning()) {
         audio_processor_.Input(data);
@@ -677,68 +773,152 @@ void Application::InputAudio() {
         wake_word_detect_.Feed(data);
     }
 #else
-    if (device_state_ == kDeviceStateListening) {
-        background_task_->Schedule([this, data = std::move(data)]() mutable {
-            opus_encoder_->Encode(std::move(data), [this](std::vector<uint8_t>&& opus) {
-                Schedule([this, opus = std::move(opus)]() {
-                    protocol_->SendAudio(opus);
-                });
-            });
+    if (GetDeviceState() == kDeviceStateListening) {
+        background_task_->ScheduleCodec([this, data = std::move(data)]() mutable {
+            EncodeAudio(std::move(data));
         });
     }
 #endif
 }
 
+// 在后台任务中执行
+void Application::EncodeAudio(std::vector<int16_t>&& data) {
+    auto start_time = esp_timer_get_time();
+    opus_encoder_->Encode(std::move(data), [this](std::vector<uint8_t>&& opus) {
+        LATENCY_TRACE(kTraceAudioEncoded);
+        Schedule([this, opus = std::move(opus)]() {
+            LATENCY_TRACE(kTraceAudioSent);
+            if (GetDeviceState() == kDeviceStateSpeaking) {
+                speaking_uplink_frames_++;
+            }
+            protocol_->SendAudio(opus);
+        });
+    });
+    auto encode_us = esp_timer_get_time() - start_time;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stats = encode_stats_[GetDeviceState()];
+    stats.frames++;
+    stats.total_us += encode_us;
+    if (encode_us > stats.max_us) {
+        stats.max_us = encode_us;
+    }
+}
+
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+void Application::UpdateAudioLevels(const int16_t* pcm, size_t samples, int channels, int sample_rate, bool output) {
+    auto start_time = esp_timer_get_time();
+    auto& analyzer = output ? output_level_analyzer_ : input_level_analyzer_;
+    auto levels = analyzer.Analyze(pcm, samples, channels, sample_rate);
+    audio_level_frames_++;
+    audio_level_us_ += esp_timer_get_time() - start_time;
+    Board::GetInstance().GetLed()->OnAudioLevels(levels, output);
+}
+#endif
+
+void Application::LogEncodeStats() {
+    EncodeStats all_stats[kDeviceStateCount];
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < kDeviceStateCount; i++) {
+            all_stats[i] = encode_stats_[i];
+            encode_stats_[i] = {};
+        }
+    }
+    for (int i = 0; i < kDeviceStateCount; i++) {
+        auto& stats = all_stats[i];
+        if (stats.frames == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "Opus encode in %s: %lu frames, avg %lld us, max %lld us",
+            DeviceStateMachine::GetStateName((DeviceState)i), stats.frames,
+            stats.total_us / stats.frames, stats.max_us);
+    }
+}
+
 void Application::AbortSpeaking(AbortReason reason) {
     ESP_LOGI(TAG, "Abort speaking");
+    LATENCY_TRACE(kTraceAbortSpeaking);
+    auto start_time = esp_timer_get_time();
     aborted_ = true;
+    decode_generation_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        audio_decode_queue_.clear();
+    }
+    // 清空 I2S DMA 中已写入的数据，立即静音
+    // 在后台任务中执行，与 OutputData 串行，排在队首；已取出的解码任务会因 generation 变化直接返回
+    background_task_->ScheduleFirst([start_time]() {
+        Board::GetInstance().GetAudioCodec()->FlushOutput();
+        LATENCY_TRACE(kTraceOutputFlushed);
+        ESP_LOGI(TAG, "Abort to silence: %lld us", esp_timer_get_time() - start_time);
+    });
+
     protocol_->SendAbortSpeaking(reason);
 }
 
-void Application::SetDeviceState(DeviceState state) {
-    if (device_state_ == state) {
-        return;
-    }
-    
-    device_state_ = state;
-    ESP_LOGI(TAG, "STATE: %s", STATE_STRINGS[device_state_]);
-    // The state is changed, wait for all background tasks to finish
-    background_task_->WaitForCompletion();
+bool Application::HandleEvent(DeviceEvent event) {
+    return state_machine_.HandleEvent(event);
+}
 
+void Application::PostEvent(DeviceEvent event) {
+    Schedule([this, event]() {
+        HandleEvent(event);
+    });
+}
+
+// 状态转换动作，不等待后台任务：解码器和编码器的重置都排在后台任务中与音频任务串行执行
+void Application::OnDeviceStateChanged(DeviceState previous, DeviceState state) {
     auto& board = Board::GetInstance();
     auto codec = board.GetAudioCodec();
     auto display = board.GetDisplay();
     auto led = board.GetLed();
     led->OnStateChanged();
+    display->OnDeviceStateChanged(state);
+    PowerManager::GetInstance().OnDeviceStateChanged(state);
     switch (state) {
         case kDeviceStateUnknown:
         case kDeviceStateIdle:
-            display->SetStatus(Lang::Strings::STANDBY);
-            display->SetEmotion("neutral");
+            display->PostStatus(Lang::Strings::STANDBY);
+            display->PostEmotion("neutral");
 #ifdef CONFIG_USE_AUDIO_PROCESSING
             audio_processor_.Stop();
 #endif
             break;
         case kDeviceStateConnecting:
-            display->SetStatus(Lang::Strings::CONNECTING);
-            display->SetChatMessage("system", "");
+            display->PostStatus(Lang::Strings::CONNECTING);
+            display->PostChatMessage("system", "");
             break;
         case kDeviceStateListening:
-            display->SetStatus(Lang::Strings::LISTENING);
-            display->SetEmotion("neutral");
-            ResetDecoder();
-            opus_encoder_->ResetState();
+            LATENCY_TRACE_BEGIN_TURN();
+            display->PostStatus(Lang::Strings::LISTENING);
+            display->PostEmotion("neutral");
+            if (!realtime_chat_enabled_) {
+                ResetDecoder();
+            }
 #if CONFIG_USE_AUDIO_PROCESSING
-            audio_processor_.Start();
+            // 实时对话模式下音频处理器在播放时保持运行，上行是连续的流
+            if (!audio_processor_.IsRunning()) {
+                background_task_->Schedule([this]() {
+                    opus_encoder_->ResetState();
+                });
+                audio_processor_.Start();
+            }
+#else
+            background_task_->Schedule([this]() {
+                opus_encoder_->ResetState();
+            });
 #endif
             UpdateIotStates();
             break;
         case kDeviceStateSpeaking:
-            display->SetStatus(Lang::Strings::SPEAKING);
+            display->PostStatus(Lang::Strings::SPEAKING);
             ResetDecoder();
             codec->EnableOutput(true);
 #if CONFIG_USE_AUDIO_PROCESSING
-            audio_processor_.Stop();
+            if (!realtime_chat_enabled_) {
+                audio_processor_.Stop();
+            }
 #endif
             break;
         default:
@@ -778,16 +958,16 @@ void Application::Reboot() {
 }
 
 void Application::WakeWordInvoke(const std::string& wake_word) {
-    if (device_state_ == kDeviceStateIdle) {
+    if (GetDeviceState() == kDeviceStateIdle) {
         ToggleChatState();
         Schedule([this, wake_word]() {
             if (protocol_) {
                 protocol_->SendWakeWordDetected(wake_word); 
             }
         }); 
-    } else if (device_state_ == kDeviceStateSpeaking) {
+    } else if (GetDeviceState() == kDeviceStateSpeaking) {
         AbortSpeaking(kAbortReasonNone);
-    } else if (device_state_ == kDeviceStateListening) {   
+    } else if (GetDeviceState() == kDeviceStateListening) {   
         if (protocol_) {
             protocol_->CloseAudioChannel();
         }
@@ -9,6 +9,7 @@
 #include <string>
 #include <mutex>
 #include <list>
+#include <atomic>
 
 #include <opus_encoder.h>
 #include <opus_decoder.h>
@@ -17,6 +18,8 @@
 #include "protocol.h"
 #include "ota.h"
 #include "background_task.h"
+#include "device_state_machine.h"
+#include "led/audio_levels.h"
 
 #if CONFIG_USE_AUDIO_PROCESSING
 #include "wake_word_detect.h"
@@ -27,19 +30,6 @@
 #define AUDIO_INPUT_READY_EVENT (1 << 1)
 #define AUDIO_OUTPUT_READY_EVENT (1 << 2)
 
-enum DeviceState {
-    kDeviceStateUnknown,
-    kDeviceStateStarting,
-    kDeviceStateWifiConfiguring,
-    kDeviceStateIdle,
-    kDeviceStateConnecting,
-    kDeviceStateListening,
-    kDeviceStateSpeaking,
-    kDeviceStateUpgrading,
-    kDeviceStateActivating,
-    kDeviceStateFatalError
-};
-
 #define OPUS_FRAME_DURATION_MS 60
 
 class Application {
@@ -53,10 +43,15 @@ public:
     Application& operator=(const Application&) = delete;
 
     void Start();
-    DeviceState GetDeviceState() const { return device_state_; }
+    DeviceState GetDeviceState() const { return state_machine_.state(); }
     bool IsVoiceDetected() const { return voice_detected_; }
+    bool IsRealtimeChat() const { return realtime_chat_enabled_; }
+    // 说话状态下发送的上行音频帧累计数，全双工时持续增长，半双工时保持不变
+    uint32_t speaking_uplink_frames() const { return speaking_uplink_frames_; }
     void Schedule(std::function<void()> callback);
-    void SetDeviceState(DeviceState state);
+    // 在主循环中同步处理状态事件，其他任务请使用 PostEvent
+    bool HandleEvent(DeviceEvent event);
+    void PostEvent(DeviceEvent event);
     void Alert(const char* status, const char* message, const char* emotion = "", const std::string_view& sound = "");
     void AbortSpeaking(AbortReason reason);
     void ToggleChatState();
@@ -80,10 +75,17 @@ private:
     std::unique_ptr<Protocol> protocol_;
     EventGroupHandle_t event_group_ = nullptr;
     esp_timer_handle_t clock_timer_handle_ = nullptr;
-    volatile DeviceState device_state_ = kDeviceStateUnknown;
+    DeviceStateMachine state_machine_;
     bool keep_listening_ = false;
     bool aborted_ = false;
+    // 全双工实时对话：播放时继续上传音频，状态切换不等待后台任务
+    bool realtime_chat_enabled_ = false;
+    // 每次打断递增，已排队的解码任务发现代数变化后直接丢弃
+    std::atomic<uint32_t> decode_generation_{0};
+    std::atomic<uint32_t> speaking_uplink_frames_{0};
     bool voice_detected_ = false;
+    // 待机睡眠时暂停了音频输入和唤醒词检测，只在主循环中访问
+    bool sleeping_ = false;
     std::string last_iot_states_;
 
     // Audio encode / decode
@@ -94,6 +96,24 @@ private:
     std::unique_ptr<OpusEncoderWrapper> opus_encoder_;
     std::unique_ptr<OpusDecoderWrapper> opus_decoder_;
 
+    // 按设备状态统计 Opus 编码耗时，用于比较 CPU 调频策略对编码的影响
+    // 在后台任务中更新、在定时器任务中读取，由 mutex_ 保护
+    struct EncodeStats {
+        uint32_t frames;
+        int64_t total_us;
+        int64_t max_us;
+    };
+    EncodeStats encode_stats_[kDeviceStateCount] = {};
+
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+    std::atomic<uint32_t> audio_level_frames_{0};
+    std::atomic<uint32_t> audio_level_us_{0};
+    // 输入在音频输入任务、输出在解码任务中分析，各自保留滤波器状态
+    AudioLevelAnalyzer input_level_analyzer_;
+    AudioLevelAnalyzer output_level_analyzer_;
+    void UpdateAudioLevels(const int16_t* pcm, size_t samples, int channels, int sample_rate, bool output);
+#endif
+
     int opus_decode_sample_rate_ = -1;
     OpusResampler input_resampler_;
     OpusResampler reference_resampler_;
@@ -101,12 +121,15 @@ private:
 
     void MainLoop();
     void InputAudio();
+    void EncodeAudio(std::vector<int16_t>&& data);
+    void LogEncodeStats();
     void OutputAudio();
     void ResetDecoder();
     void SetDecodeSampleRate(int sample_rate);
     void CheckNewVersion();
     void ShowActivationCode();
     void OnClockTimer();
+    void OnDeviceStateChanged(DeviceState previous, DeviceState state);
     void PlayLocalFile(const char* data, size_t size);
 };
 
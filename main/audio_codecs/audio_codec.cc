@@ -4,14 +4,33 @@
 
 #include <esp_log.h>
 #include <cstring>
+#include <algorithm>
 #include <driver/i2s_common.h>
 
 #define TAG "AudioCodec"
 
 AudioCodec::AudioCodec() {
+    esp_timer_create_args_t volume_save_timer_args = {
+        .callback = [](void* arg) {
+            auto codec = (AudioCodec*)arg;
+            codec->SaveOutputVolume();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "volume_save_timer",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&volume_save_timer_args, &volume_save_timer_));
 }
 
 AudioCodec::~AudioCodec() {
+    if (volume_save_timer_ != nullptr) {
+        if (esp_timer_is_active(volume_save_timer_)) {
+            esp_timer_stop(volume_save_timer_);
+            SaveOutputVolume();
+        }
+        esp_timer_delete(volume_save_timer_);
+    }
 }
 
 void AudioCodec::OnInputReady(std::function<bool()> callback) {
@@ -23,7 +42,28 @@ void AudioCodec::OnOutputReady(std::function<bool()> callback) {
 }
 
 void AudioCodec::OutputData(std::vector<int16_t>& data) {
-    Write(data.data(), data.size());
+    // 软静音：增益逐采样过渡到 0，避免直接截断波形产生爆音
+    int32_t target = output_muted_ ? 0 : OUTPUT_GAIN_UNITY;
+    mute_gain_ = ApplyGainRamp(data.data(), data.size(), mute_gain_.load(), target, gain_ramp_step_);
+
+    // 芯片音量一次跳到新值会产生爆音，在本帧的写入之间逐级调整；写入按播放速度阻塞，每级间隔约 OUTPUT_VOLUME_STEP_MS
+    int volume = output_volume_;
+    int hardware_volume = hardware_volume_;
+    size_t offset = 0;
+    if (hardware_volume >= 0 && hardware_volume != volume) {
+        size_t step_samples = std::max(1, output_sample_rate_ / 1000 * OUTPUT_VOLUME_STEP_MS * output_channels_);
+        while (hardware_volume != volume && offset < data.size()) {
+            hardware_volume += hardware_volume < volume ? 1 : -1;
+            SetHardwareVolume(hardware_volume);
+            size_t count = std::min(step_samples, data.size() - offset);
+            Write(data.data() + offset, count);
+            offset += count;
+        }
+        hardware_volume_ = hardware_volume;
+    }
+    if (offset < data.size()) {
+        Write(data.data() + offset, data.size() - offset);
+    }
 }
 
 bool AudioCodec::InputData(std::vector<int16_t>& data) {
@@ -58,28 +98,86 @@ void AudioCodec::Start() {
     Settings settings("audio", false);
     output_volume_ = settings.GetInt("output_volume", output_volume_);
 
-    // 注册音频数据回调
-    i2s_event_callbacks_t rx_callbacks = {};
-    rx_callbacks.on_recv = on_recv;
-    i2s_channel_register_event_callback(rx_handle_, &rx_callbacks, this);
+    gain_ramp_step_ = GainRampStep(output_sample_rate_, output_channels_);
 
-    i2s_event_callbacks_t tx_callbacks = {};
-    tx_callbacks.on_sent = on_sent;
-    i2s_channel_register_event_callback(tx_handle_, &tx_callbacks, this);
+    // 注册音频数据回调，没有 I2S 通道的编解码器（如模拟器）自行驱动回调
+    if (rx_handle_ != nullptr) {
+        i2s_event_callbacks_t rx_callbacks = {};
+        rx_callbacks.on_recv = on_recv;
+        i2s_channel_register_event_callback(rx_handle_, &rx_callbacks, this);
+    }
 
-    ESP_ERROR_CHECK(i2s_channel_enable(tx_handle_));
-    ESP_ERROR_CHECK(i2s_channel_enable(rx_handle_));
+    if (tx_handle_ != nullptr) {
+        i2s_event_callbacks_t tx_callbacks = {};
+        tx_callbacks.on_sent = on_sent;
+        i2s_channel_register_event_callback(tx_handle_, &tx_callbacks, this);
+    }
+
+    if (tx_handle_ != nullptr) {
+        ESP_ERROR_CHECK(i2s_channel_enable(tx_handle_));
+    }
+    if (rx_handle_ != nullptr) {
+        ESP_ERROR_CHECK(i2s_channel_enable(rx_handle_));
+    }
 
     EnableInput(true);
     EnableOutput(true);
 }
 
+// 有芯片音量的编解码器在播放下一帧时逐级调整到新音量，输出关闭时在下次打开输出时设置
 void AudioCodec::SetOutputVolume(int volume) {
     output_volume_ = volume;
     ESP_LOGI(TAG, "Set output volume to %d", output_volume_);
-    
+
+    // 服务器可能连续调节音量，延迟保存以合并多次写入 flash
+    esp_timer_stop(volume_save_timer_);
+    esp_timer_start_once(volume_save_timer_, OUTPUT_VOLUME_SAVE_DELAY_MS * 1000);
+}
+
+void AudioCodec::SaveOutputVolume() {
     Settings settings("audio", true);
-    settings.SetInt("output_volume", output_volume_);
+    if (settings.GetInt("output_volume", -1) != output_volume_) {
+        settings.SetInt("output_volume", output_volume_);
+    }
+}
+
+void AudioCodec::SetOutputMute(bool mute) {
+    if (mute == output_muted_) {
+        return;
+    }
+    output_muted_ = mute;
+    ESP_LOGI(TAG, "Set output mute to %s", mute ? "true" : "false");
+}
+
+void AudioCodec::FlushOutput() {
+    if (tx_handle_ == nullptr || !output_enabled_) {
+        return;
+    }
+    // 禁用通道会等待正在进行的写入完成，调用者需要保证与 OutputData 在同一个任务中串行执行
+    esp_err_t err = i2s_channel_disable(tx_handle_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to disable output channel: %s", esp_err_to_name(err));
+        return;
+    }
+
+    // 重新启用前用静音填满 DMA 缓冲区，覆盖尚未播放的旧数据
+    static const uint8_t silence[256] = {};
+    size_t bytes_loaded;
+    do {
+        bytes_loaded = 0;
+        err = i2s_channel_preload_data(tx_handle_, silence, sizeof(silence), &bytes_loaded);
+    } while (err == ESP_OK && bytes_loaded == sizeof(silence));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to preload silence: %s", esp_err_to_name(err));
+    }
+
+    err = i2s_channel_enable(tx_handle_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable output channel: %s", esp_err_to_name(err));
+        return;
+    }
+    // 下一段音频从 0 增益淡入，避免重新启动 DMA 后出现爆音
+    mute_gain_ = 0;
 }
 
 void AudioCodec::EnableInput(bool enable) {
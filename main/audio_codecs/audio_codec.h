@@ -4,12 +4,20 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
 #include <driver/i2s_std.h>
+#include <esp_timer.h>
 
 #include <vector>
 #include <string>
 #include <functional>
+#include <atomic>
 
 #include "board.h"
+#include "output_gain.h"
+
+// 音量设置延迟写入 NVS，合并连续的调节
+#define OUTPUT_VOLUME_SAVE_DELAY_MS 3000
+// 芯片音量每播放这么多毫秒的音频调整一级，0 到 100 的变化在 100 ms 内完成
+#define OUTPUT_VOLUME_STEP_MS 1
 
 class AudioCodec {
 public:
@@ -19,6 +27,10 @@ public:
     virtual void SetOutputVolume(int volume);
     virtual void EnableInput(bool enable);
     virtual void EnableOutput(bool enable);
+    void SetOutputMute(bool mute);
+    // 丢弃已写入 DMA 但尚未播放的数据，用于打断播放
+    // 必须在调用 OutputData 的任务中执行，避免与正在进行的写入交错
+    virtual void FlushOutput();
 
     void Start();
     void OutputData(std::vector<int16_t>& data);
@@ -33,15 +45,21 @@ public:
     inline int input_channels() const { return input_channels_; }
     inline int output_channels() const { return output_channels_; }
     inline int output_volume() const { return output_volume_; }
+    inline bool output_muted() const { return output_muted_; }
 
 private:
-    std::function<bool()> on_input_ready_;
-    std::function<bool()> on_output_ready_;
+    esp_timer_handle_t volume_save_timer_ = nullptr;
+    std::atomic<int32_t> mute_gain_{OUTPUT_GAIN_UNITY};
+
+    void SaveOutputVolume();
     
     IRAM_ATTR static bool on_recv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
     IRAM_ATTR static bool on_sent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
 
 protected:
+    std::function<bool()> on_input_ready_;
+    std::function<bool()> on_output_ready_;
+
     i2s_chan_handle_t tx_handle_ = nullptr;
     i2s_chan_handle_t rx_handle_ = nullptr;
 
@@ -54,9 +72,21 @@ protected:
     int input_channels_ = 1;
     int output_channels_ = 1;
     int output_volume_ = 70;
+    volatile bool output_muted_ = false;
+    int32_t gain_ramp_step_ = 256;
+    // 芯片当前的输出音量，-1 表示没有芯片音量，由 Write 自行按 output_volume_ 缩放采样
+    // 打开输出时设为 output_volume_，之后由 OutputData 逐级调整
+    std::atomic<int> hardware_volume_{-1};
+
+    // 增益每个采样向目标值移动一步，在 OUTPUT_GAIN_RAMP_MS 内完成满幅度过渡
+    inline int32_t RampGain(int32_t gain, int32_t target) const {
+        return ::RampGain(gain, target, gain_ramp_step_);
+    }
 
     virtual int Read(int16_t* dest, int samples) = 0;
     virtual int Write(const int16_t* data, int samples) = 0;
+    // 设置芯片的输出音量，在调用 OutputData 的任务中执行
+    virtual void SetHardwareVolume(int volume) {}
 };
 
 #endif // _AUDIO_CODEC_H
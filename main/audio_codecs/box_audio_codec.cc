@@ -178,9 +178,10 @@ void BoxAudioCodec::CreateDuplexChannels(gpio_num_t mclk, gpio_num_t bclk, gpio_
     ESP_LOGI(TAG, "Duplex channels created");
 }
 
-void BoxAudioCodec::SetOutputVolume(int volume) {
-    ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, volume));
-    AudioCodec::SetOutputVolume(volume);
+void BoxAudioCodec::SetHardwareVolume(int volume) {
+    if (output_enabled_) {
+        ESP_ERROR_CHECK_WITHOUT_ABORT(esp_codec_dev_set_out_vol(output_dev_, volume));
+    }
 }
 
 void BoxAudioCodec::EnableInput(bool enable) {
@@ -221,6 +222,7 @@ void BoxAudioCodec::EnableOutput(bool enable) {
         };
         ESP_ERROR_CHECK(esp_codec_dev_open(output_dev_, &fs));
         ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, output_volume_));
+        hardware_volume_ = output_volume_;
     } else {
         ESP_ERROR_CHECK(esp_codec_dev_close(output_dev_));
     }
@@ -181,9 +181,10 @@ void CoreS3AudioCodec::CreateDuplexChannels(gpio_num_t mclk, gpio_num_t bclk, gp
     ESP_LOGI(TAG, "Duplex channels created");
 }
 
-void CoreS3AudioCodec::SetOutputVolume(int volume) {
-    ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, volume));
-    AudioCodec::SetOutputVolume(volume);
+void CoreS3AudioCodec::SetHardwareVolume(int volume) {
+    if (output_enabled_) {
+        ESP_ERROR_CHECK_WITHOUT_ABORT(esp_codec_dev_set_out_vol(output_dev_, volume));
+    }
 }
 
 void CoreS3AudioCodec::EnableInput(bool enable) {
@@ -224,6 +225,7 @@ void CoreS3AudioCodec::EnableOutput(bool enable) {
         };
         ESP_ERROR_CHECK(esp_codec_dev_open(output_dev_, &fs));
         ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, output_volume_));
+        hardware_volume_ = output_volume_;
     } else {
         ESP_ERROR_CHECK(esp_codec_dev_close(output_dev_));
     }
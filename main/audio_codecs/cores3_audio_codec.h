@@ -22,6 +22,7 @@ private:
 
     virtual int Read(int16_t* dest, int samples) override;
     virtual int Write(const int16_t* data, int samples) override;
+    virtual void SetHardwareVolume(int volume) override;
 
 public:
     CoreS3AudioCodec(void* i2c_master_handle, int input_sample_rate, int output_sample_rate,
@@ -29,7 +30,6 @@ public:
         uint8_t aw88298_addr, uint8_t es7210_addr, bool input_reference);
     virtual ~CoreS3AudioCodec();
 
-    virtual void SetOutputVolume(int volume) override;
     virtual void EnableInput(bool enable) override;
     virtual void EnableOutput(bool enable) override;
 };
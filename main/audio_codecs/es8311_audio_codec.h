@@ -23,6 +23,7 @@ private:
 
     virtual int Read(int16_t* dest, int samples) override;
     virtual int Write(const int16_t* data, int samples) override;
+    virtual void SetHardwareVolume(int volume) override;
 
 public:
     Es8311AudioCodec(void* i2c_master_handle, i2c_port_t i2c_port, int input_sample_rate, int output_sample_rate,
@@ -30,7 +31,6 @@ public:
         gpio_num_t pa_pin, uint8_t es8311_addr, bool use_mclk = true);
     virtual ~Es8311AudioCodec();
 
-    virtual void SetOutputVolume(int volume) override;
     virtual void EnableInput(bool enable) override;
     virtual void EnableOutput(bool enable) override;
 };
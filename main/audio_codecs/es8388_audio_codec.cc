@@ -131,9 +131,10 @@ void Es8388AudioCodec::CreateDuplexChannels(gpio_num_t mclk, gpio_num_t bclk, gp
     ESP_LOGI(TAG, "Duplex channels created");
 }
 
-void Es8388AudioCodec::SetOutputVolume(int volume) {
-    ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, volume));
-    AudioCodec::SetOutputVolume(volume);
+void Es8388AudioCodec::SetHardwareVolume(int volume) {
+    if (output_enabled_) {
+        ESP_ERROR_CHECK_WITHOUT_ABORT(esp_codec_dev_set_out_vol(output_dev_, volume));
+    }
 }
 
 void Es8388AudioCodec::EnableInput(bool enable) {
@@ -170,6 +171,7 @@ void Es8388AudioCodec::EnableOutput(bool enable) {
         };
         ESP_ERROR_CHECK(esp_codec_dev_open(output_dev_, &fs));
         ESP_ERROR_CHECK(esp_codec_dev_set_out_vol(output_dev_, output_volume_));
+        hardware_volume_ = output_volume_;
 
         // Set analog output volume to 0dB, default is -45dB
         uint8_t reg_val = 30; // 0dB
@@ -1,7 +1,7 @@
 #include "no_audio_codec.h"
+#include "output_gain.h"
 
 #include <esp_log.h>
-#include <cmath>
 
 #define TAG "NoAudioCodec"
 
@@ -335,32 +335,37 @@ NoAudioCodecSimplexPdm::NoAudioCodecSimplexPdm(int input_sample_rate, int output
 }
 
 int NoAudioCodec::Write(const int16_t* data, int samples) {
-    std::vector<int32_t> buffer(samples);
+    if (output_buffer_.size() < (size_t)samples) {
+        output_buffer_.resize(samples);
+    }
 
     // output_volume_: 0-100
-    // volume_factor_: 0-65536
-    int32_t volume_factor = pow(double(output_volume_) / 100.0, 2) * 65536;
-    for (int i = 0; i < samples; i++) {
-        int64_t temp = int64_t(data[i]) * volume_factor; // 使用 int64_t 进行乘法运算
-        if (temp > INT32_MAX) {
-            buffer[i] = INT32_MAX;
-        } else if (temp < INT32_MIN) {
-            buffer[i] = INT32_MIN;
-        } else {
-            buffer[i] = static_cast<int32_t>(temp);
-        }
+    // volume_factor: 0-65536
+    int32_t target = VolumeToFactor(output_volume_);
+    int32_t* buffer = output_buffer_.data();
+    int i = 0;
+    // 音量变化时逐采样过渡到目标增益，避免阶跃产生的拉链噪声
+    for (; i < samples && volume_factor_ != target; i++) {
+        volume_factor_ = RampGain(volume_factor_, target);
+        buffer[i] = int32_t(data[i]) * volume_factor_;
+    }
+    for (; i < samples; i++) {
+        buffer[i] = int32_t(data[i]) * target;
     }
 
     size_t bytes_written;
-    ESP_ERROR_CHECK(i2s_channel_write(tx_handle_, buffer.data(), samples * sizeof(int32_t), &bytes_written, portMAX_DELAY));
+    ESP_ERROR_CHECK(i2s_channel_write(tx_handle_, buffer, samples * sizeof(int32_t), &bytes_written, portMAX_DELAY));
     return bytes_written / sizeof(int32_t);
 }
 
 int NoAudioCodec::Read(int16_t* dest, int samples) {
     size_t bytes_read;
 
-    std::vector<int32_t> bit32_buffer(samples);
-    if (i2s_channel_read(rx_handle_, bit32_buffer.data(), samples * sizeof(int32_t), &bytes_read, portMAX_DELAY) != ESP_OK) {
+    if (input_buffer_.size() < (size_t)samples) {
+        input_buffer_.resize(samples);
+    }
+    int32_t* bit32_buffer = input_buffer_.data();
+    if (i2s_channel_read(rx_handle_, bit32_buffer, samples * sizeof(int32_t), &bytes_read, portMAX_DELAY) != ESP_OK) {
         ESP_LOGE(TAG, "Read Failed!");
         return 0;
     }
@@ -8,6 +8,11 @@
 
 class NoAudioCodec : public AudioCodec {
 private:
+    // 复用的 I2S 32 位收发缓冲区，避免每次读写都分配内存
+    std::vector<int32_t> output_buffer_;
+    std::vector<int32_t> input_buffer_;
+    int32_t volume_factor_ = 0;
+
     virtual int Write(const int16_t* data, int samples) override;
     virtual int Read(int16_t* dest, int samples) override;
 
@@ -0,0 +1,37 @@
+#include "output_gain.h"
+
+#include <cmath>
+#include <array>
+
+static const std::array<int32_t, 101> kVolumeFactors = []() {
+    std::array<int32_t, 101> factors;
+    for (int i = 0; i <= 100; i++) {
+        factors[i] = static_cast<int32_t>(pow(double(i) / 100.0, 2) * 65536);
+    }
+    return factors;
+}();
+
+int32_t VolumeToFactor(int volume) {
+    int index = volume < 0 ? 0 : (volume > 100 ? 100 : volume);
+    return kVolumeFactors[index];
+}
+
+int32_t GainRampStep(int sample_rate, int channels) {
+    int ramp_samples = sample_rate / 1000 * OUTPUT_GAIN_RAMP_MS * channels;
+    if (ramp_samples <= 0) {
+        return OUTPUT_GAIN_UNITY;
+    }
+    int32_t step = OUTPUT_GAIN_UNITY / ramp_samples;
+    return step < 1 ? 1 : step;
+}
+
+int32_t ApplyGainRamp(int16_t* samples, size_t count, int32_t gain, int32_t target, int32_t step) {
+    if (gain == OUTPUT_GAIN_UNITY && target == OUTPUT_GAIN_UNITY) {
+        return gain;
+    }
+    for (size_t i = 0; i < count; i++) {
+        gain = RampGain(gain, target, step);
+        samples[i] = (int32_t(samples[i]) * gain) >> 16;
+    }
+    return gain;
+}
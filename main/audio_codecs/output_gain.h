@@ -0,0 +1,31 @@
+#ifndef _OUTPUT_GAIN_H
+#define _OUTPUT_GAIN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Q16 定点增益，65536 表示 1.0
+#define OUTPUT_GAIN_UNITY 65536
+// 音量和静音变化的平滑过渡时间
+#define OUTPUT_GAIN_RAMP_MS 10
+
+// 音量曲线: volume_factor = (output_volume / 100)^2 * 65536，预先计算避免每次写入调用 pow()
+// 最大值 65536 保证 int16 * factor 不会超出 int32 范围，因此无需 64 位乘法和饱和判断
+// volume 超出 0-100 时按边界取值
+int32_t VolumeToFactor(int volume);
+
+// 在 OUTPUT_GAIN_RAMP_MS 内完成 0 到 OUTPUT_GAIN_UNITY 满幅度过渡所需的每采样步长
+int32_t GainRampStep(int sample_rate, int channels);
+
+// 增益每个采样向目标值移动一步
+inline int32_t RampGain(int32_t gain, int32_t target, int32_t step) {
+    if (gain < target) {
+        return (target - gain > step) ? gain + step : target;
+    }
+    return (gain - target > step) ? gain - step : target;
+}
+
+// 原地按增益缩放采样，增益逐采样向 target 过渡，避免阶跃产生爆音，返回处理后的增益
+int32_t ApplyGainRamp(int16_t* samples, size_t count, int32_t gain, int32_t target, int32_t step);
+
+#endif // _OUTPUT_GAIN_H
@@ -0,0 +1,200 @@
+#include "simulated_audio_codec.h"
+
+#include <esp_log.h>
+#include <cstdio>
+
+#define TAG "SimulatedAudioCodec"
+
+// 与 NoAudioCodec 的 DMA 配置保持一致：输入每 30ms 一帧，输出 6 个 10ms 的缓冲
+#define SIMULATED_INPUT_FRAME_MS 30
+#define SIMULATED_OUTPUT_FRAME_MS 10
+#define SIMULATED_OUTPUT_BUFFER_MS 60
+
+SimulatedAudioCodec::SimulatedAudioCodec(int input_sample_rate, int output_sample_rate, int speed_factor,
+    bool input_reference) {
+    duplex_ = true;
+    input_reference_ = input_reference;
+    input_channels_ = input_reference_ ? 2 : 1;
+    input_sample_rate_ = input_sample_rate;
+    output_sample_rate_ = output_sample_rate;
+    speed_factor_ = speed_factor > 0 ? speed_factor : 1;
+
+    // 回调在 esp_timer 任务中执行，模拟 I2S 中断通知主循环
+    esp_timer_create_args_t input_timer_args = {
+        .callback = [](void* arg) {
+            auto codec = (SimulatedAudioCodec*)arg;
+            if (codec->input_enabled_ && codec->on_input_ready_) {
+                codec->on_input_ready_();
+            }
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "sim_input_timer",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&input_timer_args, &input_timer_));
+
+    esp_timer_create_args_t output_timer_args = {
+        .callback = [](void* arg) {
+            auto codec = (SimulatedAudioCodec*)arg;
+            if (codec->output_enabled_ && codec->on_output_ready_) {
+                codec->on_output_ready_();
+            }
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "sim_output_timer",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&output_timer_args, &output_timer_));
+    ESP_LOGI(TAG, "Simulated codec created, speed factor %d", speed_factor_);
+}
+
+SimulatedAudioCodec::~SimulatedAudioCodec() {
+    if (input_timer_ != nullptr) {
+        esp_timer_stop(input_timer_);
+        esp_timer_delete(input_timer_);
+    }
+    if (output_timer_ != nullptr) {
+        esp_timer_stop(output_timer_);
+        esp_timer_delete(output_timer_);
+    }
+}
+
+void SimulatedAudioCodec::SetInputSource(const int16_t* pcm, size_t samples, bool loop) {
+    input_source_ = pcm;
+    input_source_samples_ = samples;
+    input_position_ = 0;
+    input_loop_ = loop;
+}
+
+bool SimulatedAudioCodec::SetInputWav(const uint8_t* wav, size_t size, bool loop) {
+    WavInfo info;
+    if (!WavFile::Parse(wav, size, info)) {
+        return false;
+    }
+    if (info.format != 1 || info.channels != 1 || info.bits_per_sample != 16 ||
+        info.sample_rate != (uint32_t)input_sample_rate_) {
+        ESP_LOGE(TAG, "Unsupported WAV format: format=%u channels=%u bits=%u rate=%lu, expected 16-bit mono %d Hz",
+            info.format, info.channels, info.bits_per_sample, info.sample_rate, input_sample_rate_);
+        return false;
+    }
+    SetInputSource((const int16_t*)info.data, info.data_size / sizeof(int16_t), loop);
+    ESP_LOGI(TAG, "Input source: %zu samples%s", input_source_samples_, loop ? ", looped" : "");
+    return true;
+}
+
+bool SimulatedAudioCodec::SetInputFile(const char* path, bool loop) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        ESP_LOGE(TAG, "Empty input file %s", path);
+        fclose(file);
+        return false;
+    }
+
+    // 先停止使用旧的数据再替换缓冲区
+    SetInputSource(nullptr, 0, loop);
+    input_file_.resize(size);
+    size_t read = fread(input_file_.data(), 1, size, file);
+    fclose(file);
+    if (read != (size_t)size) {
+        ESP_LOGE(TAG, "Failed to read %s", path);
+        input_file_.clear();
+        return false;
+    }
+    ESP_LOGI(TAG, "Input file %s, %ld bytes", path, size);
+    return SetInputWav(input_file_.data(), input_file_.size(), loop);
+}
+
+bool SimulatedAudioCodec::SetOutputWav(const char* path, size_t max_bytes) {
+    return output_wav_.Open(path, output_sample_rate_, output_channels_, max_bytes);
+}
+
+void SimulatedAudioCodec::OnOutputData(std::function<void(const int16_t* data, int samples)> callback) {
+    on_output_data_ = callback;
+}
+
+void SimulatedAudioCodec::FlushOutput() {
+    // 模拟缓冲区中尚未播放的数据直接丢弃
+    output_deadline_us_ = 0;
+}
+
+void SimulatedAudioCodec::EnableInput(bool enable) {
+    if (enable == input_enabled_) {
+        return;
+    }
+    if (enable) {
+        ESP_ERROR_CHECK(esp_timer_start_periodic(input_timer_, SIMULATED_INPUT_FRAME_MS * 1000 / speed_factor_));
+    } else {
+        esp_timer_stop(input_timer_);
+    }
+    AudioCodec::EnableInput(enable);
+}
+
+void SimulatedAudioCodec::EnableOutput(bool enable) {
+    if (enable == output_enabled_) {
+        return;
+    }
+    if (enable) {
+        output_deadline_us_ = 0;
+        ESP_ERROR_CHECK(esp_timer_start_periodic(output_timer_, SIMULATED_OUTPUT_FRAME_MS * 1000 / speed_factor_));
+    } else {
+        esp_timer_stop(output_timer_);
+    }
+    AudioCodec::EnableOutput(enable);
+}
+
+int SimulatedAudioCodec::Read(int16_t* dest, int samples) {
+    // 模拟麦克风不会拾取扬声器的声音，参考通道填充静音即可满足 AEC 的输入格式
+    int frames = samples / input_channels_;
+    for (int i = 0; i < frames; i++) {
+        int16_t mic = 0;
+        if (input_position_ < input_source_samples_) {
+            mic = input_source_[input_position_++];
+            if (input_loop_ && input_position_ == input_source_samples_) {
+                input_position_ = 0;
+            }
+        }
+        dest[i * input_channels_] = mic;
+        if (input_reference_) {
+            dest[i * input_channels_ + 1] = 0;
+        }
+    }
+    input_frames_++;
+    return samples;
+}
+
+int SimulatedAudioCodec::Write(const int16_t* data, int samples) {
+    if (!output_enabled_) {
+        return samples;
+    }
+    if (on_output_data_) {
+        on_output_data_(data, samples);
+    }
+    output_wav_.Write(data, samples);
+    output_samples_ += samples;
+
+    // 按播放时长阻塞写入，模拟 I2S DMA 缓冲区满时的背压
+    int64_t now = esp_timer_get_time();
+    int64_t duration_us = int64_t(samples) * 1000000 / (output_sample_rate_ * output_channels_) / speed_factor_;
+    if (output_deadline_us_ != 0 && output_deadline_us_ < now) {
+        output_underruns_++;
+    }
+    if (output_deadline_us_ < now) {
+        output_deadline_us_ = now;
+    }
+    output_deadline_us_ += duration_us;
+
+    int64_t wait_us = output_deadline_us_ - now - SIMULATED_OUTPUT_BUFFER_MS * 1000 / speed_factor_;
+    if (wait_us > 0) {
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000));
+    }
+    return samples;
+}
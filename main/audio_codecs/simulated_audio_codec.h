@@ -0,0 +1,67 @@
+#ifndef _SIMULATED_AUDIO_CODEC_H
+#define _SIMULATED_AUDIO_CODEC_H
+
+#include "audio_codec.h"
+#include "wav_file.h"
+
+#include <esp_timer.h>
+
+#include <functional>
+#include <atomic>
+#include <vector>
+
+// 不依赖 I2S 硬件的编解码器，用定时器模拟 DMA 节拍
+// 输入来自 PCM/WAV 数据或 WAV 文件（未设置时为静音），输出交给回调处理并可录制成 WAV 文件
+class SimulatedAudioCodec : public AudioCodec {
+private:
+    esp_timer_handle_t input_timer_ = nullptr;
+    esp_timer_handle_t output_timer_ = nullptr;
+    int speed_factor_ = 1;
+
+    const int16_t* input_source_ = nullptr;
+    size_t input_source_samples_ = 0;
+    size_t input_position_ = 0;
+    bool input_loop_ = true;
+    // SetInputFile 读入的文件内容，input_source_ 指向其中的 PCM 数据
+    std::vector<uint8_t> input_file_;
+
+    std::function<void(const int16_t* data, int samples)> on_output_data_;
+    WavWriter output_wav_;
+    int64_t output_deadline_us_ = 0;
+
+    std::atomic<uint32_t> input_frames_{0};
+    std::atomic<uint32_t> output_samples_{0};
+    // 输出缓冲区被播放空的次数（包括句子之间的正常停顿）
+    std::atomic<uint32_t> output_underruns_{0};
+
+    virtual int Read(int16_t* dest, int samples) override;
+    virtual int Write(const int16_t* data, int samples) override;
+
+public:
+    // speed_factor 大于 1 时以快于实时的速度运行，用于吞吐量测试
+    // input_reference 为 true 时输入为双声道（麦克风 + 回声参考），用于全双工实时对话
+    SimulatedAudioCodec(int input_sample_rate, int output_sample_rate, int speed_factor = 1,
+        bool input_reference = false);
+    virtual ~SimulatedAudioCodec();
+
+    // loop 为 false 时输入数据只播放一次，之后输入静音
+    void SetInputSource(const int16_t* pcm, size_t samples, bool loop = true);
+    // wav 的内容必须在编解码器使用期间保持有效
+    bool SetInputWav(const uint8_t* wav, size_t size, bool loop = true);
+    // 读取整个 WAV 文件作为输入，文件格式必须是 16 位单声道且采样率与输入一致
+    bool SetInputFile(const char* path, bool loop = true);
+    // 把写入扬声器的数据（静音和音量处理之后）录制到 WAV 文件
+    bool SetOutputWav(const char* path, size_t max_bytes = 0);
+    void OnOutputData(std::function<void(const int16_t* data, int samples)> callback);
+
+    virtual void FlushOutput() override;
+    virtual void EnableInput(bool enable) override;
+    virtual void EnableOutput(bool enable) override;
+
+    inline uint32_t input_frames() const { return input_frames_; }
+    inline uint32_t output_samples() const { return output_samples_; }
+    inline uint32_t output_underruns() const { return output_underruns_; }
+    inline size_t output_wav_bytes() const { return output_wav_.data_size(); }
+};
+
+#endif // _SIMULATED_AUDIO_CODEC_H
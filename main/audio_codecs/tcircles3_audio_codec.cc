@@ -1,6 +1,7 @@
 #include "tcircles3_audio_codec.h"
 
 #include <esp_log.h>
+#include <cstring>
 #include <driver/i2c.h>
 #include <driver/i2c_master.h>
 #include <driver/i2s_tdm.h>
@@ -92,11 +93,6 @@ void Tcircles3AudioCodec::CreateVoiceHardware(gpio_num_t mic_bclk, gpio_num_t mi
     ESP_LOGI(TAG, "Voice hardware created");
 }
 
-void Tcircles3AudioCodec::SetOutputVolume(int volume) {
-    volume_ = volume;
-    AudioCodec::SetOutputVolume(volume);
-}
-
 void Tcircles3AudioCodec::EnableInput(bool enable) {
     AudioCodec::EnableInput(enable);
 }
@@ -118,17 +114,14 @@ int Tcircles3AudioCodec::Read(int16_t *dest, int samples){
     return samples;
 }
 
-void AdjustVolume(const int16_t *input_data, int16_t *output_data, size_t samples, float volume){
-    for (size_t i = 0; i < samples; i++){
-        output_data[i] = (float)input_data[i] * volume;
-    }
-}
-
 int Tcircles3AudioCodec::Write(const int16_t *data, int samples){
     if (output_enabled_){
         size_t bytes_read;
         auto output_data = (int16_t *)malloc(samples * sizeof(int16_t));
-        AdjustVolume(data, output_data, samples, (float)(volume_ / 100.0));
+        memcpy(output_data, data, samples * sizeof(int16_t));
+        // 线性音量曲线，音量变化时逐采样过渡，避免阶跃产生爆音
+        int32_t target = output_volume_ * OUTPUT_GAIN_UNITY / 100;
+        volume_factor_ = ApplyGainRamp(output_data, samples, volume_factor_, target, gain_ramp_step_);
         i2s_channel_write(tx_handle_, output_data, samples * sizeof(int16_t), &bytes_read, portMAX_DELAY);
         free(output_data);
     }
@@ -0,0 +1,155 @@
+#include "wav_file.h"
+
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "WavFile"
+
+static uint16_t ReadLe16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t ReadLe32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+static void WriteLe16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static void WriteLe32(uint8_t* p, uint32_t value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = value >> 24;
+}
+
+bool WavFile::Parse(const uint8_t* wav, size_t size, WavInfo& info) {
+    info = WavInfo();
+    if (size < 12 || memcmp(wav, "RIFF", 4) != 0 || memcmp(wav + 8, "WAVE", 4) != 0) {
+        ESP_LOGE(TAG, "Invalid WAV header");
+        return false;
+    }
+
+    bool has_format = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t* chunk = wav + offset;
+        uint32_t chunk_size = ReadLe32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && size - offset - 8 >= 16) {
+            info.format = ReadLe16(chunk + 8);
+            info.channels = ReadLe16(chunk + 10);
+            info.sample_rate = ReadLe32(chunk + 12);
+            info.bits_per_sample = ReadLe16(chunk + 22);
+            has_format = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!has_format) {
+                ESP_LOGE(TAG, "WAV data chunk before fmt chunk");
+                return false;
+            }
+            info.data = chunk + 8;
+            info.data_size = chunk_size < size - offset - 8 ? chunk_size : size - offset - 8;
+            return true;
+        }
+        if (chunk_size > size - offset - 8) {
+            break;
+        }
+        offset += 8 + chunk_size + (chunk_size & 1);
+    }
+    ESP_LOGE(TAG, "WAV data chunk not found");
+    return false;
+}
+
+void WavFile::MakeHeader(uint8_t header[WAV_HEADER_SIZE], int sample_rate, int channels, uint32_t data_size) {
+    const int bits_per_sample = 16;
+    memcpy(header, "RIFF", 4);
+    WriteLe32(header + 4, 36 + data_size);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    WriteLe32(header + 16, 16);
+    WriteLe16(header + 20, 1);
+    WriteLe16(header + 22, channels);
+    WriteLe32(header + 24, sample_rate);
+    WriteLe32(header + 28, sample_rate * channels * bits_per_sample / 8);
+    WriteLe16(header + 32, channels * bits_per_sample / 8);
+    WriteLe16(header + 34, bits_per_sample);
+    memcpy(header + 36, "data", 4);
+    WriteLe32(header + 40, data_size);
+}
+
+WavWriter::~WavWriter() {
+    Close();
+}
+
+bool WavWriter::Open(const char* path, int sample_rate, int channels, size_t max_bytes) {
+    Close();
+    file_ = fopen(path, "wb");
+    if (file_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return false;
+    }
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    max_bytes_ = max_bytes;
+    data_size_ = 0;
+    synced_size_ = 0;
+
+    uint8_t header[WAV_HEADER_SIZE];
+    WavFile::MakeHeader(header, sample_rate_, channels_, 0);
+    if (fwrite(header, 1, sizeof(header), file_) != sizeof(header)) {
+        ESP_LOGE(TAG, "Failed to write WAV header to %s", path);
+        Close();
+        return false;
+    }
+    ESP_LOGI(TAG, "Recording %d Hz %d ch to %s", sample_rate_, channels_, path);
+    return true;
+}
+
+void WavWriter::Write(const int16_t* data, int samples) {
+    if (file_ == nullptr || samples <= 0) {
+        return;
+    }
+    size_t bytes = samples * sizeof(int16_t);
+    if (max_bytes_ > 0 && data_size_ + bytes > max_bytes_) {
+        bytes = (max_bytes_ - data_size_) / sizeof(int16_t) * sizeof(int16_t);
+        if (bytes == 0) {
+            return;
+        }
+    }
+    size_t written = fwrite(data, 1, bytes, file_);
+    data_size_ += written / sizeof(int16_t) * sizeof(int16_t);
+    if (written != bytes) {
+        ESP_LOGE(TAG, "WAV write failed after %u bytes", (unsigned)data_size_);
+        Close();
+        return;
+    }
+
+    // 每写满一秒的数据回写一次文件头
+    if (data_size_ - synced_size_ >= size_t(sample_rate_ * channels_) * sizeof(int16_t)) {
+        Sync();
+    }
+}
+
+void WavWriter::Sync() {
+    if (file_ == nullptr) {
+        return;
+    }
+    uint8_t header[WAV_HEADER_SIZE];
+    WavFile::MakeHeader(header, sample_rate_, channels_, data_size_);
+    long position = ftell(file_);
+    fseek(file_, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), file_);
+    fseek(file_, position, SEEK_SET);
+    fflush(file_);
+    synced_size_ = data_size_;
+}
+
+void WavWriter::Close() {
+    if (file_ == nullptr) {
+        return;
+    }
+    Sync();
+    fclose(file_);
+    file_ = nullptr;
+    ESP_LOGI(TAG, "Recorded %u bytes", (unsigned)data_size_);
+}
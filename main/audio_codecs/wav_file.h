@@ -0,0 +1,52 @@
+#ifndef _WAV_FILE_H
+#define _WAV_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#define WAV_HEADER_SIZE 44
+
+struct WavInfo {
+    uint16_t format = 0;        // 1 表示 PCM
+    uint16_t channels = 0;
+    uint32_t sample_rate = 0;
+    uint16_t bits_per_sample = 0;
+    const uint8_t* data = nullptr;
+    size_t data_size = 0;
+};
+
+// RIFF/WAVE 文件的解析和生成，只支持模拟器和测试用到的 PCM 格式
+class WavFile {
+public:
+    // 查找 fmt 和 data 块，data 指向 wav 内部；data 块长度超出文件时按实际长度截断
+    static bool Parse(const uint8_t* wav, size_t size, WavInfo& info);
+    // 生成 16 位 PCM 的标准 44 字节文件头
+    static void MakeHeader(uint8_t header[WAV_HEADER_SIZE], int sample_rate, int channels, uint32_t data_size);
+};
+
+// 把 16 位 PCM 写入 WAV 文件，定期回写文件头，异常断电或复位时已写入的数据仍然可以播放
+class WavWriter {
+public:
+    ~WavWriter();
+
+    // max_bytes 为 0 时不限制文件大小，达到上限后丢弃后续数据
+    bool Open(const char* path, int sample_rate, int channels, size_t max_bytes = 0);
+    void Write(const int16_t* data, int samples);
+    // 回写文件头并刷新到存储
+    void Sync();
+    void Close();
+
+    inline bool is_open() const { return file_ != nullptr; }
+    inline size_t data_size() const { return data_size_; }
+
+private:
+    FILE* file_ = nullptr;
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    size_t max_bytes_ = 0;
+    size_t data_size_ = 0;
+    size_t synced_size_ = 0;
+};
+
+#endif // _WAV_FILE_H
@@ -10,13 +10,14 @@ AudioProcessor::AudioProcessor()
     event_group_ = xEventGroupCreate();
 }
 
-void AudioProcessor::Initialize(int channels, bool reference) {
+void AudioProcessor::Initialize(int channels, bool reference, bool realtime_chat) {
     channels_ = channels;
     reference_ = reference;
     int ref_num = reference_ ? 1 : 0;
 
     afe_config_t afe_config = {
-        .aec_init = false,
+        // 实时对话时播放与采集同时进行，需要回声消除
+        .aec_init = reference_ && realtime_chat,
         .se_init = true,
         .vad_init = false,
         .wakenet_init = false,
@@ -75,11 +76,13 @@ void AudioProcessor::Input(const std::vector<int16_t>& data) {
 }
 
 void AudioProcessor::Start() {
+    cpu_lock_.Acquire();
     xEventGroupSetBits(event_group_, PROCESSOR_RUNNING);
 }
 
 void AudioProcessor::Stop() {
     xEventGroupClearBits(event_group_, PROCESSOR_RUNNING);
+    cpu_lock_.Release();
 }
 
 bool AudioProcessor::IsRunning() {
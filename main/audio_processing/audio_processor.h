@@ -10,12 +10,14 @@
 #include <vector>
 #include <functional>
 
+#include "cpu_frequency_lock.h"
+
 class AudioProcessor {
 public:
     AudioProcessor();
     ~AudioProcessor();
 
-    void Initialize(int channels, bool reference);
+    void Initialize(int channels, bool reference, bool realtime_chat = false);
     void Input(const std::vector<int16_t>& data);
     void Start();
     void Stop();
@@ -29,6 +31,8 @@ private:
     std::function<void(std::vector<int16_t>&& data)> output_callback_;
     int channels_;
     bool reference_;
+    // 运行期间保持 CPU 最高频率
+    CpuFrequencyLock cpu_lock_{"audio_processor"};
 
     void AudioProcessorTask();
 };
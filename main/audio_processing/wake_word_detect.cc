@@ -100,11 +100,13 @@ void WakeWordDetect::OnVadStateChange(std::function<void(bool speaking)> callbac
 }
 
 void WakeWordDetect::StartDetection() {
+    cpu_lock_.Acquire();
     xEventGroupSetBits(event_group_, DETECTION_RUNNING_EVENT);
 }
 
 void WakeWordDetect::StopDetection() {
     xEventGroupClearBits(event_group_, DETECTION_RUNNING_EVENT);
+    cpu_lock_.Release();
 }
 
 bool WakeWordDetect::IsDetectionRunning() {
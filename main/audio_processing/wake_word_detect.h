@@ -15,6 +15,8 @@
 #include <mutex>
 #include <condition_variable>
 
+#include "cpu_frequency_lock.h"
+
 
 class WakeWordDetect {
 public:
@@ -44,6 +46,8 @@ private:
     int channels_;
     bool reference_;
     std::string last_detected_wake_word_;
+    // 运行期间保持 CPU 最高频率
+    CpuFrequencyLock cpu_lock_{"wake_word_detect"};
 
     TaskHandle_t wake_word_encode_task_ = nullptr;
     StaticTask_t wake_word_encode_task_buffer_;
@@ -18,6 +18,18 @@ BackgroundTask::~BackgroundTask() {
 }
 
 void BackgroundTask::Schedule(std::function<void()> callback) {
+    Enqueue(std::move(callback), false);
+}
+
+void BackgroundTask::ScheduleFirst(std::function<void()> callback) {
+    Enqueue(std::move(callback), true);
+}
+
+void BackgroundTask::ScheduleCodec(std::function<void()> callback) {
+    Enqueue(std::move(callback), false, true);
+}
+
+void BackgroundTask::Enqueue(std::function<void()>&& callback, bool first, bool codec) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (active_tasks_ >= 30) {
         int free_sram = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
@@ -26,7 +38,10 @@ void BackgroundTask::Schedule(std::function<void()> callback) {
         }
     }
     active_tasks_++;
-    main_tasks_.emplace_back([this, cb = std::move(callback)]() {
+    auto task = [this, codec, cb = std::move(callback)]() {
+        if (codec) {
+            cpu_lock_.Acquire();
+        }
         cb();
         {
             std::lock_guard<std::mutex> lock(mutex_);
@@ -35,7 +50,12 @@ void BackgroundTask::Schedule(std::function<void()> callback) {
                 condition_variable_.notify_all();
             }
         }
-    });
+    };
+    if (first) {
+        main_tasks_.emplace_front(std::move(task));
+    } else {
+        main_tasks_.emplace_back(std::move(task));
+    }
     condition_variable_.notify_all();
 }
 
@@ -50,7 +70,10 @@ void BackgroundTask::BackgroundTaskLoop() {
     ESP_LOGI(TAG, "background_task started");
     while (true) {
         std::unique_lock<std::mutex> lock(mutex_);
-        condition_variable_.wait(lock, [this]() { return !main_tasks_.empty(); });
+        if (main_tasks_.empty()) {
+            cpu_lock_.Release();
+            condition_variable_.wait(lock, [this]() { return !main_tasks_.empty(); });
+        }
         
         std::list<std::function<void()>> tasks = std::move(main_tasks_);
         lock.unlock();
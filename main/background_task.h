@@ -4,16 +4,23 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <mutex>
+#include <functional>
 #include <list>
 #include <condition_variable>
 #include <atomic>
 
+#include "cpu_frequency_lock.h"
+
 class BackgroundTask {
 public:
     BackgroundTask(uint32_t stack_size = 4096 * 2);
     ~BackgroundTask();
 
     void Schedule(std::function<void()> callback);
+    // 插到队列最前面，用于打断播放等需要尽快执行的任务
+    void ScheduleFirst(std::function<void()> callback);
+    // Opus 编解码等重计算任务，执行期间持有 CPU 最高频率，直到队列清空
+    void ScheduleCodec(std::function<void()> callback);
     void WaitForCompletion();
 
 private:
@@ -22,7 +29,10 @@ private:
     std::condition_variable condition_variable_;
     TaskHandle_t background_task_handle_ = nullptr;
     std::atomic<size_t> active_tasks_{0};
+    // 只在执行 ScheduleCodec 提交的任务时获取，队列清空后释放，其他任务不影响调频
+    CpuFrequencyLock cpu_lock_{"background_task"};
 
+    void Enqueue(std::function<void()>&& callback, bool first, bool codec = false);
     void BackgroundTaskLoop();
 };
 
@@ -110,9 +110,9 @@ private:
         InitializeSpi();
         InitializeGc9107Display();
         InitializeButtons();
-        display_->SetStatus(Lang::Strings::ERROR);
-        display_->SetEmotion("sad");
-        display_->SetChatMessage("system", "Echo Base\nnot connected");
+        display_->PostStatus(Lang::Strings::ERROR);
+        display_->PostEmotion("sad");
+        display_->PostChatMessage("system", "Echo Base\nnot connected");
         
         while (1) {
             ESP_LOGE(TAG, "Atomic Echo Base is disconnected");
@@ -1,4 +1,5 @@
 #include "button.h"
+#include "power_manager.h"
 
 #include <esp_log.h>
 
@@ -14,7 +15,10 @@ Button::Button(gpio_num_t gpio_num, bool active_high) : gpio_num_(gpio_num) {
         .short_press_time = 50,
         .gpio_button_config = {
             .gpio_num = gpio_num,
-            .active_level = static_cast<uint8_t>(active_high ? 1 : 0)
+            .active_level = static_cast<uint8_t>(active_high ? 1 : 0),
+#if CONFIG_GPIO_BUTTON_SUPPORT_POWER_SAVE
+            .enable_power_save = true,
+#endif
         }
     };
     button_handle_ = iot_button_create(&button_config);
@@ -22,6 +26,13 @@ Button::Button(gpio_num_t gpio_num, bool active_high) : gpio_num_(gpio_num) {
         ESP_LOGE(TAG, "Failed to create button handle");
         return;
     }
+
+    // 任何按键都会唤醒设备并重新开始待机计时
+    auto& power_manager = PowerManager::GetInstance();
+    power_manager.AddWakeupGpio(gpio_num, active_high);
+    iot_button_register_cb(button_handle_, BUTTON_PRESS_DOWN, [](void* handle, void* usr_data) {
+        PowerManager::GetInstance().WakeUp();
+    }, nullptr);
 }
 
 Button::~Button() {
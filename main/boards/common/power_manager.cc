@@ -0,0 +1,220 @@
+#include "power_manager.h"
+
+#include <esp_log.h>
+#include <esp_sleep.h>
+
+#define TAG "PowerManager"
+
+static const char* const POWER_STATE_STRINGS[] = {
+    "active",
+    "idle",
+    "sleep",
+};
+
+PowerManager::PowerManager() {
+    state_enter_time_us_ = esp_timer_get_time();
+
+#if CONFIG_PM_ENABLE
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "power_active", &cpu_lock_));
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "power_awake", &no_sleep_lock_));
+    UpdateLocks();
+
+    // 没有任何锁时降到晶振频率，是否允许自动浅睡眠取决于 FreeRTOS tickless idle
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_XTAL_FREQ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#else
+        .light_sleep_enable = false,
+#endif
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+#endif
+
+    esp_timer_create_args_t tick_timer_args = {
+        .callback = [](void* arg) {
+            auto manager = static_cast<PowerManager*>(arg);
+            manager->OnTick();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "power_tick",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&tick_timer_args, &tick_timer_));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer_, 1000000));
+}
+
+PowerManager::~PowerManager() {
+    if (tick_timer_ != nullptr) {
+        esp_timer_stop(tick_timer_);
+        esp_timer_delete(tick_timer_);
+    }
+#if CONFIG_PM_ENABLE
+    if (cpu_locked_) {
+        esp_pm_lock_release(cpu_lock_);
+    }
+    if (no_sleep_locked_) {
+        esp_pm_lock_release(no_sleep_lock_);
+    }
+    esp_pm_lock_delete(cpu_lock_);
+    esp_pm_lock_delete(no_sleep_lock_);
+#endif
+}
+
+void PowerManager::Configure(int seconds_to_sleep, int seconds_to_shutdown) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seconds_to_sleep_ = seconds_to_sleep;
+    seconds_to_shutdown_ = seconds_to_shutdown;
+}
+
+void PowerManager::SetCurrentModel(int active_ma, int idle_ma, int sleep_ma) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_ma_[kPowerStateActive] = active_ma;
+    current_ma_[kPowerStateIdle] = idle_ma;
+    current_ma_[kPowerStateSleep] = sleep_ma;
+}
+
+void PowerManager::OnEnterSleep(std::function<void()> callback) {
+    on_enter_sleep_ = callback;
+}
+
+void PowerManager::OnExitSleep(std::function<void()> callback) {
+    on_exit_sleep_ = callback;
+}
+
+void PowerManager::OnShutdownRequest(std::function<void()> callback) {
+    on_shutdown_request_ = callback;
+}
+
+void PowerManager::AddWakeupGpio(gpio_num_t gpio, bool active_high) {
+    if (gpio == GPIO_NUM_NC) {
+        return;
+    }
+    // 引脚不支持唤醒时只是无法从浅睡眠中唤醒，不影响其他功能
+    esp_err_t err = gpio_wakeup_enable(gpio, active_high ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable wakeup on GPIO %d: %s", gpio, esp_err_to_name(err));
+        return;
+    }
+    err = esp_sleep_enable_gpio_wakeup();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enable GPIO wakeup: %s", esp_err_to_name(err));
+    }
+}
+
+void PowerManager::OnDeviceStateChanged(DeviceState state) {
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        device_idle_ = state == kDeviceStateIdle;
+        idle_seconds_ = 0;
+        callback = SetState(device_idle_ ? kPowerStateIdle : kPowerStateActive);
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+void PowerManager::WakeUp() {
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_seconds_ = 0;
+        if (state_ == kPowerStateSleep) {
+            callback = SetState(kPowerStateIdle);
+        }
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+void PowerManager::OnTick() {
+    std::function<void()> callback;
+    bool request_shutdown = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!device_idle_) {
+            return;
+        }
+        idle_seconds_++;
+        if (state_ == kPowerStateIdle && seconds_to_sleep_ != -1 && idle_seconds_ >= seconds_to_sleep_) {
+            callback = SetState(kPowerStateSleep);
+        }
+        request_shutdown = seconds_to_shutdown_ != -1 && idle_seconds_ >= seconds_to_shutdown_;
+    }
+    if (callback) {
+        callback();
+    }
+    if (request_shutdown && on_shutdown_request_) {
+        on_shutdown_request_();
+    }
+}
+
+std::function<void()> PowerManager::SetState(PowerState state) {
+    PowerState previous = state_;
+    if (state == previous) {
+        return nullptr;
+    }
+
+    auto now = esp_timer_get_time();
+    state_time_us_[previous] += now - state_enter_time_us_;
+    state_enter_time_us_ = now;
+    state_ = state;
+    UpdateLocks();
+    ESP_LOGI(TAG, "Power state: %s -> %s", POWER_STATE_STRINGS[previous], POWER_STATE_STRINGS[state]);
+
+    if (state == kPowerStateSleep) {
+        return on_enter_sleep_;
+    }
+    if (previous == kPowerStateSleep) {
+        return on_exit_sleep_;
+    }
+    return nullptr;
+}
+
+void PowerManager::UpdateLocks() {
+#if CONFIG_PM_ENABLE
+    // 待机时的唤醒词检测和编解码各自持有 CpuFrequencyLock
+    bool need_cpu = state_ == kPowerStateActive;
+    bool need_awake = state_ != kPowerStateSleep;
+    if (need_cpu != cpu_locked_) {
+        ESP_ERROR_CHECK(need_cpu ? esp_pm_lock_acquire(cpu_lock_) : esp_pm_lock_release(cpu_lock_));
+        cpu_locked_ = need_cpu;
+    }
+    if (need_awake != no_sleep_locked_) {
+        ESP_ERROR_CHECK(need_awake ? esp_pm_lock_acquire(no_sleep_lock_) : esp_pm_lock_release(no_sleep_lock_));
+        no_sleep_locked_ = need_awake;
+    }
+#endif
+}
+
+void PowerManager::LogReport() {
+    int64_t time_us[kPowerStateCount];
+    int current_ma[kPowerStateCount];
+    PowerState state;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state = state_;
+        for (int i = 0; i < kPowerStateCount; i++) {
+            time_us[i] = state_time_us_[i];
+            current_ma[i] = current_ma_[i];
+        }
+        time_us[state] += esp_timer_get_time() - state_enter_time_us_;
+    }
+
+    int64_t total_us = 0;
+    double charge_mas = 0;
+    for (int i = 0; i < kPowerStateCount; i++) {
+        total_us += time_us[i];
+        charge_mas += current_ma[i] * (time_us[i] / 1000000.0);
+    }
+    if (total_us == 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "Power (%s): active %lld s, idle %lld s, sleep %lld s, estimated %.1f mAh, avg %.1f mA",
+        POWER_STATE_STRINGS[state], time_us[kPowerStateActive] / 1000000, time_us[kPowerStateIdle] / 1000000,
+        time_us[kPowerStateSleep] / 1000000, charge_mas / 3600.0, charge_mas / (total_us / 1000000.0));
+}
@@ -0,0 +1,91 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <driver/gpio.h>
+#include <esp_timer.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+#include <functional>
+#include <mutex>
+#include <atomic>
+
+#include "device_state_machine.h"
+
+// 各功耗状态的估算电流，用于能耗报告，板子可按实测值调用 SetCurrentModel 修改
+#define POWER_ACTIVE_CURRENT_MA 120
+#define POWER_IDLE_CURRENT_MA 60
+#define POWER_SLEEP_CURRENT_MA 15
+
+enum PowerState {
+    kPowerStateActive,  // 对话、配网、升级等，CPU 保持最高频率且不允许浅睡眠
+    kPowerStateIdle,    // 待机，允许动态调频
+    kPowerStateSleep,   // 待机超时，允许自动浅睡眠
+    kPowerStateCount
+};
+
+// 所有板子共用的功耗管理：按设备状态持有或释放 esp_pm 锁，待机超时后进入浅睡眠，
+// 按键或网络事件唤醒；同时统计各功耗状态的停留时间并估算能耗
+// 其他模块持有的电源锁（唤醒词检测、I2S）由 OnEnterSleep / OnExitSleep 的回调负责释放和恢复
+class PowerManager {
+public:
+    static PowerManager& GetInstance() {
+        static PowerManager instance;
+        return instance;
+    }
+    // 删除拷贝构造函数和赋值运算符
+    PowerManager(const PowerManager&) = delete;
+    PowerManager& operator=(const PowerManager&) = delete;
+
+    // 待机多少秒后进入睡眠、请求关机，-1 表示不进入该阶段
+    void Configure(int seconds_to_sleep, int seconds_to_shutdown);
+    void SetCurrentModel(int active_ma, int idle_ma, int sleep_ma);
+    void OnEnterSleep(std::function<void()> callback);
+    void OnExitSleep(std::function<void()> callback);
+    // 待机超过关机时间后每秒调用一次，由板子决定是否真正关机
+    void OnShutdownRequest(std::function<void()> callback);
+    // 浅睡眠期间可以唤醒芯片的按键
+    void AddWakeupGpio(gpio_num_t gpio, bool active_high);
+
+    void OnDeviceStateChanged(DeviceState state);
+    // 按键、网络等事件，重新开始待机计时，睡眠中则立即唤醒
+    void WakeUp();
+    // 打印各功耗状态的累计时间和估算能耗
+    void LogReport();
+
+    inline PowerState state() const { return state_; }
+
+private:
+    PowerManager();
+    ~PowerManager();
+
+    std::mutex mutex_;
+    volatile PowerState state_ = kPowerStateActive;
+    bool device_idle_ = false;
+    int idle_seconds_ = 0;
+    int seconds_to_sleep_ = CONFIG_POWER_SLEEP_TIMEOUT_S > 0 ? CONFIG_POWER_SLEEP_TIMEOUT_S : -1;
+    int seconds_to_shutdown_ = -1;
+    int current_ma_[kPowerStateCount] = { POWER_ACTIVE_CURRENT_MA, POWER_IDLE_CURRENT_MA, POWER_SLEEP_CURRENT_MA };
+    int64_t state_enter_time_us_ = 0;
+    int64_t state_time_us_[kPowerStateCount] = {};
+    esp_timer_handle_t tick_timer_ = nullptr;
+
+    std::function<void()> on_enter_sleep_;
+    std::function<void()> on_exit_sleep_;
+    std::function<void()> on_shutdown_request_;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t cpu_lock_ = nullptr;
+    esp_pm_lock_handle_t no_sleep_lock_ = nullptr;
+    bool cpu_locked_ = false;
+    bool no_sleep_locked_ = false;
+#endif
+
+    void OnTick();
+    // 需要在持有 mutex_ 时调用，返回需要在锁外执行的回调
+    std::function<void()> SetState(PowerState state);
+    void UpdateLocks();
+};
+
+#endif // POWER_MANAGER_H
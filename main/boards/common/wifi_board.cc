@@ -38,7 +38,7 @@ std::string WifiBoard::GetBoardType() {
 
 void WifiBoard::EnterWifiConfigMode() {
     auto& application = Application::GetInstance();
-    application.SetDeviceState(kDeviceStateWifiConfiguring);
+    application.PostEvent(kDeviceEventConfigureWifi);
 
     auto& wifi_ap = WifiConfigurationAp::GetInstance();
     wifi_ap.SetLanguage(Lang::CODE);
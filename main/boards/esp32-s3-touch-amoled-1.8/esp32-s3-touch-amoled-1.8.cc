@@ -61,6 +61,10 @@ public:
                         .text_font = &font_puhui_30_4,
                         .icon_font = &font_awesome_30_4,
                         .emoji_font = font_emoji_64_init(),
+                    },
+                    {
+                        .lines = 20,
+                        .double_buffer = true,
                     }) {
         DisplayLockGuard lock(this);
         lv_obj_set_style_pad_left(status_bar_, LV_HOR_RES * 0.1, 0);
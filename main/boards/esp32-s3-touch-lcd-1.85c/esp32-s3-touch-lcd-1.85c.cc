@@ -116,6 +116,10 @@ private:
                                         .text_font = &font_puhui_16_4,
                                         .icon_font = &font_awesome_16_4,
                                         .emoji_font = font_emoji_64_init(),
+                                    },
+                                    {
+                                        .lines = 20,
+                                        .double_buffer = true,
                                     });
     }
 
@@ -3,6 +3,7 @@
 #include "display/ssd1306_display.h"
 #include "application.h"
 #include "button.h"
+#include "power_manager.h"
 #include "config.h"
 #include "axp2101.h"
 #include "iot/thing_manager.h"
@@ -11,7 +12,6 @@
 #include <esp_log.h>
 #include <driver/gpio.h>
 #include <driver/i2c_master.h>
-#include <esp_timer.h>
 
 #define TAG "KevinBoxBoard"
 
@@ -27,40 +27,17 @@ private:
     Button volume_up_button_;
     Button volume_down_button_;
     uint8_t _data_buffer[2];
-    esp_timer_handle_t power_save_timer_ = nullptr;
 
-    void InitializePowerSaveTimer() {
-        esp_timer_create_args_t power_save_timer_args = {
-            .callback = [](void *arg) {
-                auto board = static_cast<KevinBoxBoard*>(arg);
-                board->PowerSaveCheck();
-            },
-            .arg = this,
-            .dispatch_method = ESP_TIMER_TASK,
-            .name = "power_save_timer",
-            .skip_unhandled_events = false,
-        };
-        ESP_ERROR_CHECK(esp_timer_create(&power_save_timer_args, &power_save_timer_));
-        ESP_ERROR_CHECK(esp_timer_start_periodic(power_save_timer_, 1000000));
-    }
-
-    void PowerSaveCheck() {
-        // 电池放电模式下，如果待机超过一定时间，则自动关机
+    void InitializePowerManager() {
+        // 电池放电模式下，如果待机超过一定时间，则自动关机；4G 模组不支持浅睡眠
         const int seconds_to_shutdown = 600;
-        static int seconds = 0;
-        if (Application::GetInstance().GetDeviceState() != kDeviceStateIdle) {
-            seconds = 0;
-            return;
-        }
-        if (!axp2101_->IsDischarging()) {
-            seconds = 0;
-            return;
-        }
-        
-        seconds++;
-        if (seconds >= seconds_to_shutdown) {
-            axp2101_->PowerOff();
-        }
+        auto& power_manager = PowerManager::GetInstance();
+        power_manager.Configure(-1, seconds_to_shutdown);
+        power_manager.OnShutdownRequest([this]() {
+            if (axp2101_->IsDischarging()) {
+                axp2101_->PowerOff();
+            }
+        });
     }
 
     void Enable4GModule() {
@@ -166,7 +143,7 @@ public:
         Enable4GModule();
 
         InitializeButtons();
-        InitializePowerSaveTimer();
+        InitializePowerManager();
         InitializeIot();
     }
     
@@ -0,0 +1,33 @@
+#ifndef _BOARD_CONFIG_H_
+#define _BOARD_CONFIG_H_
+
+#include <driver/gpio.h>
+
+#define AUDIO_INPUT_SAMPLE_RATE  16000
+#define AUDIO_OUTPUT_SAMPLE_RATE 24000
+
+// 模拟音频的运行速度倍数，1 为实时，大于 1 时快于实时
+#define SIMULATOR_SPEED_FACTOR   1
+// 模拟回声参考通道，开启 CONFIG_USE_REALTIME_CHAT 时需要
+#define SIMULATOR_INPUT_REFERENCE true
+// 打印音频统计信息的间隔
+#define SIMULATOR_STATS_INTERVAL_MS 10000
+
+// 模拟音频文件存放在 storage 分区（SPIFFS，见 partitions_simulator.csv）
+// 写入输入文件：
+//   python $IDF_PATH/components/spiffs/spiffsgen.py 0x300000 <含 input.wav 的目录> storage.bin
+//   parttool.py write_partition --partition-name storage --input storage.bin
+// 读取录制的输出：
+//   parttool.py read_partition --partition-name storage --output storage.bin，再用 mkspiffs 等工具解包
+#define SIMULATOR_STORAGE_PATH  "/storage"
+// 麦克风输入，16 位单声道，采样率与 AUDIO_INPUT_SAMPLE_RATE 一致；文件不存在时输入静音
+#define SIMULATOR_INPUT_WAV     SIMULATOR_STORAGE_PATH "/input.wav"
+// 输入播放完后从头重复，每次重复都会触发新一轮对话
+#define SIMULATOR_INPUT_LOOP    true
+// 扬声器输出，只包含实际播放的音频，不包含句子之间的静音
+#define SIMULATOR_OUTPUT_WAV    SIMULATOR_STORAGE_PATH "/output.wav"
+#define SIMULATOR_OUTPUT_WAV_MAX_BYTES (2 * 1024 * 1024)
+
+#define BOOT_BUTTON_GPIO        GPIO_NUM_0
+
+#endif // _BOARD_CONFIG_H_
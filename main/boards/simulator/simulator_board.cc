@@ -0,0 +1,101 @@
+#include "wifi_board.h"
+#include "audio_codecs/simulated_audio_codec.h"
+#include "application.h"
+#include "button.h"
+#include "config.h"
+#include "iot/thing_manager.h"
+
+#include <wifi_station.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_spiffs.h>
+
+#define TAG "SimulatorBoard"
+
+// 无需音频硬件的开发板，音频输入输出由 SimulatedAudioCodec 模拟
+// 用于在任意开发板上跑通完整的 Application 流程并统计延迟和吞吐量
+// 麦克风输入来自 storage 分区中的 WAV 文件，扬声器输出录制到同一分区，可离线对比完整的对话
+class SimulatorBoard : public WifiBoard {
+private:
+    Button boot_button_;
+    esp_timer_handle_t stats_timer_ = nullptr;
+    uint32_t last_speaking_uplink_frames_ = 0;
+
+    void InitializeButtons() {
+        boot_button_.OnClick([this]() {
+            auto& app = Application::GetInstance();
+            if (app.GetDeviceState() == kDeviceStateStarting && !WifiStation::GetInstance().IsConnected()) {
+                ResetWifiConfiguration();
+            }
+            app.ToggleChatState();
+        });
+    }
+
+    // 物联网初始化，添加对 AI 可见设备
+    void InitializeIot() {
+        auto& thing_manager = iot::ThingManager::GetInstance();
+        thing_manager.AddThing(iot::CreateThing("Speaker"));
+    }
+
+    void MountStorage() {
+        esp_vfs_spiffs_conf_t conf = {
+            .base_path = SIMULATOR_STORAGE_PATH,
+            .partition_label = "storage",
+            .max_files = 4,
+            .format_if_mount_failed = true,
+        };
+        esp_err_t err = esp_vfs_spiffs_register(&conf);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to mount storage: %s, input is silence", esp_err_to_name(err));
+        }
+    }
+
+    void InitializeAudioFiles() {
+        auto codec = static_cast<SimulatedAudioCodec*>(GetAudioCodec());
+        if (!codec->SetInputFile(SIMULATOR_INPUT_WAV, SIMULATOR_INPUT_LOOP)) {
+            ESP_LOGW(TAG, "No input WAV, input is silence");
+        }
+        codec->SetOutputWav(SIMULATOR_OUTPUT_WAV, SIMULATOR_OUTPUT_WAV_MAX_BYTES);
+    }
+
+    void InitializeStatsTimer() {
+        esp_timer_create_args_t stats_timer_args = {
+            .callback = [](void* arg) {
+                auto board = static_cast<SimulatorBoard*>(arg);
+                auto codec = static_cast<SimulatedAudioCodec*>(board->GetAudioCodec());
+                ESP_LOGI(TAG, "Input frames: %lu, output samples: %lu, output underruns: %lu, recorded %u bytes",
+                    codec->input_frames(), codec->output_samples(), codec->output_underruns(),
+                    (unsigned)codec->output_wav_bytes());
+
+                // 说话期间仍有上行音频帧发出，说明上下行同时在流动（全双工）
+                uint32_t uplink_frames = Application::GetInstance().speaking_uplink_frames();
+                uint32_t delta = uplink_frames - board->last_speaking_uplink_frames_;
+                board->last_speaking_uplink_frames_ = uplink_frames;
+                ESP_LOGI(TAG, "Uplink frames sent while speaking: %lu", delta);
+            },
+            .arg = this,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "simulator_stats",
+            .skip_unhandled_events = true,
+        };
+        ESP_ERROR_CHECK(esp_timer_create(&stats_timer_args, &stats_timer_));
+        ESP_ERROR_CHECK(esp_timer_start_periodic(stats_timer_, SIMULATOR_STATS_INTERVAL_MS * 1000));
+    }
+
+public:
+    SimulatorBoard() : boot_button_(BOOT_BUTTON_GPIO) {
+        InitializeButtons();
+        InitializeIot();
+        MountStorage();
+        InitializeAudioFiles();
+        InitializeStatsTimer();
+    }
+
+    virtual AudioCodec* GetAudioCodec() override {
+        static SimulatedAudioCodec audio_codec(AUDIO_INPUT_SAMPLE_RATE, AUDIO_OUTPUT_SAMPLE_RATE,
+            SIMULATOR_SPEED_FACTOR, SIMULATOR_INPUT_REFERENCE);
+        return &audio_codec;
+    }
+};
+
+DECLARE_BOARD(SimulatorBoard);
@@ -6,6 +6,7 @@
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_vendor.h>
 #include <esp_lvgl_port.h>
+#include "lvgl_port_config.h"
 
 #include <driver/ledc.h>
 #include <driver/gpio.h>
@@ -78,7 +79,7 @@ XINGZHI_Ssd1306Display::XINGZHI_Ssd1306Display(void* i2c_master_handle, int widt
     });
 
     ESP_LOGI(TAG, "Initialize LVGL");
-    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_cfg_t port_cfg = GetLvglPortConfig();
     lvgl_port_init(&port_cfg);
 
     // SSD1306 config
@@ -154,6 +155,9 @@ XINGZHI_Ssd1306Display::XINGZHI_Ssd1306Display(void* i2c_master_handle, int widt
         return;
     }
 
+    InitializeRenderStats();
+    InitializeIdleSuspend();
+
     if (height_ == 64) {
         SetupUI_128x64();
     } else {
@@ -6,6 +6,7 @@
 #include <driver/ledc.h>
 #include <vector>
 #include <esp_lvgl_port.h>
+#include "lvgl_port_config.h"
 #include <esp_timer.h>
 #include "assets/lang_config.h"
 
@@ -107,7 +108,7 @@ XINGZHI_1_54_TFT_LcdDisplay::XINGZHI_1_54_TFT_LcdDisplay(esp_lcd_panel_io_handle
     lv_init();
 
     ESP_LOGI(TAG, "Initialize LVGL port");
-    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_cfg_t port_cfg = GetLvglPortConfig();
     lvgl_port_init(&port_cfg);
 
     ESP_LOGI(TAG, "Adding LCD screen");
@@ -143,6 +144,9 @@ XINGZHI_1_54_TFT_LcdDisplay::XINGZHI_1_54_TFT_LcdDisplay(esp_lcd_panel_io_handle
         return;
     }
 
+    InitializeRenderStats();
+    InitializeIdleSuspend();
+
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
     }
@@ -0,0 +1,34 @@
+#include "cpu_frequency_lock.h"
+
+#include <esp_err.h>
+
+CpuFrequencyLock::CpuFrequencyLock(const char* name) {
+#if CONFIG_PM_ENABLE
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, name, &handle_));
+#endif
+}
+
+CpuFrequencyLock::~CpuFrequencyLock() {
+#if CONFIG_PM_ENABLE
+    Release();
+    esp_pm_lock_delete(handle_);
+#endif
+}
+
+void CpuFrequencyLock::Acquire() {
+    if (held_.exchange(true)) {
+        return;
+    }
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_acquire(handle_);
+#endif
+}
+
+void CpuFrequencyLock::Release() {
+    if (!held_.exchange(false)) {
+        return;
+    }
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_release(handle_);
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef CPU_FREQUENCY_LOCK_H
+#define CPU_FREQUENCY_LOCK_H
+
+#include <sdkconfig.h>
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+#include <atomic>
+
+// 编解码、音频前端等重计算在工作期间持有 CPU 最高频率，空闲时释放，允许动态调频降频
+// Acquire / Release 可重复调用，未开启 CONFIG_PM_ENABLE 时为空操作
+class CpuFrequencyLock {
+public:
+    explicit CpuFrequencyLock(const char* name);
+    ~CpuFrequencyLock();
+    CpuFrequencyLock(const CpuFrequencyLock&) = delete;
+    CpuFrequencyLock& operator=(const CpuFrequencyLock&) = delete;
+
+    void Acquire();
+    void Release();
+    inline bool held() const { return held_; }
+
+private:
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t handle_ = nullptr;
+#endif
+    std::atomic<bool> held_{false};
+};
+
+#endif // CPU_FREQUENCY_LOCK_H
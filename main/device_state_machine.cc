@@ -0,0 +1,151 @@
+#include "device_state_machine.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "StateMachine"
+
+static const char* const STATE_STRINGS[] = {
+    "unknown",
+    "starting",
+    "configuring",
+    "idle",
+    "connecting",
+    "listening",
+    "speaking",
+    "upgrading",
+    "activating",
+    "fatal_error",
+    "invalid_state"
+};
+
+static const char* const EVENT_STRINGS[] = {
+    "start",
+    "configure_wifi",
+    "activate",
+    "ready",
+    "connect",
+    "listen",
+    "speak",
+    "stop",
+    "reset",
+    "upgrade",
+    "invalid_event"
+};
+
+struct StateTransition {
+    DeviceState from;
+    DeviceEvent event;
+    DeviceState to;
+};
+
+// 目标状态与当前状态相同的条目表示允许但无需处理的事件
+static const StateTransition TRANSITIONS[] = {
+    { kDeviceStateUnknown,        kDeviceEventStart,         kDeviceStateStarting },
+    { kDeviceStateStarting,       kDeviceEventConfigureWifi, kDeviceStateWifiConfiguring },
+    { kDeviceStateStarting,       kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateStarting,       kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateStarting,       kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateIdle,           kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateIdle,           kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateIdle,           kDeviceEventConnect,       kDeviceStateConnecting },
+    { kDeviceStateIdle,           kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateIdle,           kDeviceEventSpeak,         kDeviceStateSpeaking },
+    { kDeviceStateIdle,           kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateIdle,           kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateIdle,           kDeviceEventUpgrade,       kDeviceStateUpgrading },
+    { kDeviceStateConnecting,     kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateConnecting,     kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateConnecting,     kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateListening,      kDeviceEventSpeak,         kDeviceStateSpeaking },
+    { kDeviceStateListening,      kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateListening,      kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateSpeaking,       kDeviceEventListen,        kDeviceStateListening },
+    { kDeviceStateSpeaking,       kDeviceEventStop,          kDeviceStateIdle },
+    { kDeviceStateSpeaking,       kDeviceEventReset,         kDeviceStateIdle },
+    { kDeviceStateActivating,     kDeviceEventActivate,      kDeviceStateActivating },
+    { kDeviceStateActivating,     kDeviceEventReady,         kDeviceStateIdle },
+    { kDeviceStateActivating,     kDeviceEventReset,         kDeviceStateIdle },
+};
+
+DeviceStateMachine::DeviceStateMachine() {
+    state_enter_time_us_ = esp_timer_get_time();
+}
+
+const char* DeviceStateMachine::GetStateName(DeviceState state) {
+    if (state < 0 || state >= kDeviceStateCount) {
+        return STATE_STRINGS[kDeviceStateCount];
+    }
+    return STATE_STRINGS[state];
+}
+
+const char* DeviceStateMachine::GetEventName(DeviceEvent event) {
+    if (event < 0 || event >= kDeviceEventCount) {
+        return EVENT_STRINGS[kDeviceEventCount];
+    }
+    return EVENT_STRINGS[event];
+}
+
+void DeviceStateMachine::OnStateChanged(std::function<void(DeviceState previous, DeviceState current)> callback) {
+    on_state_changed_ = callback;
+}
+
+bool DeviceStateMachine::HandleEvent(DeviceEvent event) {
+    DeviceState previous = state_;
+    const StateTransition* transition = nullptr;
+    for (const auto& t : TRANSITIONS) {
+        if (t.from == previous && t.event == event) {
+            transition = &t;
+            break;
+        }
+    }
+
+    if (transition == nullptr) {
+        rejected_events_++;
+        ESP_LOGW(TAG, "Event %s rejected in state %s", GetEventName(event), GetStateName(previous));
+        return false;
+    }
+    if (transition->to == previous) {
+        return true;
+    }
+
+    auto now = esp_timer_get_time();
+    metrics_[previous].total_time_us += now - state_enter_time_us_;
+    state_enter_time_us_ = now;
+    state_ = transition->to;
+
+    if (on_state_changed_) {
+        on_state_changed_(previous, state_);
+    }
+
+    auto action_us = esp_timer_get_time() - now;
+    auto& metrics = metrics_[state_];
+    metrics.enter_count++;
+    metrics.total_action_us += action_us;
+    if (action_us > metrics.max_action_us) {
+        metrics.max_action_us = action_us;
+    }
+    ESP_LOGI(TAG, "STATE: %s -> %s (%s), action %lld us",
+        GetStateName(previous), GetStateName(state_), GetEventName(event), action_us);
+    return true;
+}
+
+void DeviceStateMachine::LogMetrics() {
+    auto now = esp_timer_get_time();
+    for (int i = 0; i < kDeviceStateCount; i++) {
+        auto& metrics = metrics_[i];
+        int64_t total_time_us = metrics.total_time_us;
+        if (i == state_) {
+            total_time_us += now - state_enter_time_us_;
+        }
+        if (metrics.enter_count == 0 && total_time_us == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-12s entered %lu times, total %lld ms, action avg %lld us max %lld us",
+            GetStateName((DeviceState)i), metrics.enter_count, total_time_us / 1000,
+            metrics.enter_count > 0 ? metrics.total_action_us / metrics.enter_count : 0, metrics.max_action_us);
+    }
+    if (rejected_events_ > 0) {
+        ESP_LOGI(TAG, "Rejected events: %lu", rejected_events_);
+    }
+}
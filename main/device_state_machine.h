@@ -0,0 +1,66 @@
+#ifndef _DEVICE_STATE_MACHINE_H_
+#define _DEVICE_STATE_MACHINE_H_
+
+#include <functional>
+#include <cstdint>
+
+enum DeviceState {
+    kDeviceStateUnknown,
+    kDeviceStateStarting,
+    kDeviceStateWifiConfiguring,
+    kDeviceStateIdle,
+    kDeviceStateConnecting,
+    kDeviceStateListening,
+    kDeviceStateSpeaking,
+    kDeviceStateUpgrading,
+    kDeviceStateActivating,
+    kDeviceStateFatalError,
+    kDeviceStateCount
+};
+
+enum DeviceEvent {
+    kDeviceEventStart,          // 上电启动
+    kDeviceEventConfigureWifi,  // 进入 WiFi 配网
+    kDeviceEventActivate,       // 需要显示激活码
+    kDeviceEventReady,          // 启动或激活完成
+    kDeviceEventConnect,        // 开始打开音频通道
+    kDeviceEventListen,         // 开始聆听
+    kDeviceEventSpeak,          // 收到 TTS 开始
+    kDeviceEventStop,           // 对话结束、通道关闭或连接失败
+    kDeviceEventReset,          // 网络模组重置
+    kDeviceEventUpgrade,        // 开始固件升级
+    kDeviceEventCount
+};
+
+// 表驱动的设备状态机，状态转换只能由转换表中列出的 (状态, 事件) 组合触发
+// 转换动作由 OnStateChanged 回调执行，状态机记录每个状态的停留时间和转换动作耗时
+class DeviceStateMachine {
+public:
+    DeviceStateMachine();
+
+    inline DeviceState state() const { return state_; }
+
+    // 查表执行状态转换，不允许的事件返回 false 并保持当前状态
+    bool HandleEvent(DeviceEvent event);
+    void OnStateChanged(std::function<void(DeviceState previous, DeviceState current)> callback);
+    void LogMetrics();
+
+    static const char* GetStateName(DeviceState state);
+    static const char* GetEventName(DeviceEvent event);
+
+private:
+    struct StateMetrics {
+        uint32_t enter_count;
+        int64_t total_time_us;
+        int64_t total_action_us;
+        int64_t max_action_us;
+    };
+
+    volatile DeviceState state_ = kDeviceStateUnknown;
+    int64_t state_enter_time_us_ = 0;
+    uint32_t rejected_events_ = 0;
+    StateMetrics metrics_[kDeviceStateCount] = {};
+    std::function<void(DeviceState previous, DeviceState current)> on_state_changed_;
+};
+
+#endif // _DEVICE_STATE_MACHINE_H_
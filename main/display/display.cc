@@ -2,8 +2,12 @@
 #include <esp_err.h>
 #include <string>
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
 
 #include "display.h"
+#include <esp_lvgl_port.h>
+#include "emotions.h"
 #include "board.h"
 #include "application.h"
 #include "font_awesome_symbols.h"
@@ -45,6 +49,34 @@ Display::Display() {
     };
     ESP_ERROR_CHECK(esp_timer_create(&update_display_timer_args, &update_timer_));
     ESP_ERROR_CHECK(esp_timer_start_periodic(update_timer_, 1000000));
+
+    // Coalesced UI update timer
+    esp_timer_create_args_t coalesce_timer_args = {
+        .callback = [](void *arg) {
+            Display *display = static_cast<Display*>(arg);
+            display->ApplyPendingUpdates();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "coalesce_timer",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&coalesce_timer_args, &coalesce_timer_));
+
+#if CONFIG_USE_BACKLIGHT_AUTO_DIM
+    // Backlight auto-dim timer
+    esp_timer_create_args_t dim_timer_args = {
+        .callback = [](void *arg) {
+            Display *display = static_cast<Display*>(arg);
+            display->OnDimTimer();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "dim_timer",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&dim_timer_args, &dim_timer_));
+#endif
 }
 
 Display::~Display() {
@@ -56,6 +88,14 @@ Display::~Display() {
         esp_timer_stop(update_timer_);
         esp_timer_delete(update_timer_);
     }
+    if (coalesce_timer_ != nullptr) {
+        esp_timer_stop(coalesce_timer_);
+        esp_timer_delete(coalesce_timer_);
+    }
+    if (dim_timer_ != nullptr) {
+        esp_timer_stop(dim_timer_);
+        esp_timer_delete(dim_timer_);
+    }
 
     if (network_label_ != nullptr) {
         lv_obj_del(network_label_);
@@ -72,7 +112,8 @@ void Display::SetStatus(const char* status) {
     if (status_label_ == nullptr) {
         return;
     }
-    lv_label_set_text(status_label_, status);
+    // 空闲时钟等重复的状态文本不触发重新排版
+    SetLabelText(status_label_, status);
     lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
 }
@@ -95,32 +136,24 @@ void Display::ShowNotification(const char* notification, int duration_ms) {
 }
 
 void Display::Update() {
+    // 没有状态栏时无需查询电池和网络状态
+    if (mute_label_ == nullptr) {
+        return;
+    }
+
     auto& board = Board::GetInstance();
     auto codec = board.GetAudioCodec();
 
-    {
-        DisplayLockGuard lock(this);
-        if (mute_label_ == nullptr) {
-            return;
-        }
-
-        // 如果静音状态改变，则更新图标
-        if (codec->output_volume() == 0 && !muted_) {
-            muted_ = true;
-            lv_label_set_text(mute_label_, FONT_AWESOME_VOLUME_MUTE);
-        } else if (codec->output_volume() > 0 && muted_) {
-            muted_ = false;
-            lv_label_set_text(mute_label_, "");
-        }
-    }
+    // 先在锁外读取所有状态，与上次显示的值比较，只有变化时才加锁更新
+    bool muted = codec->output_muted() || codec->output_volume() == 0;
 
     // 更新电池图标
     int battery_level;
     bool charging;
-    const char* icon = nullptr;
+    const char* battery_icon = battery_icon_;
     if (board.GetBatteryLevel(battery_level, charging)) {
         if (charging) {
-            icon = FONT_AWESOME_BATTERY_CHARGING;
+            battery_icon = FONT_AWESOME_BATTERY_CHARGING;
         } else {
             const char* levels[] = {
                 FONT_AWESOME_BATTERY_EMPTY, // 0-19%
@@ -130,16 +163,12 @@ void Display::Update() {
                 FONT_AWESOME_BATTERY_FULL, // 80-99%
                 FONT_AWESOME_BATTERY_FULL, // 100%
             };
-            icon = levels[battery_level / 20];
-        }
-        DisplayLockGuard lock(this);
-        if (battery_label_ != nullptr && battery_icon_ != icon) {
-            battery_icon_ = icon;
-            lv_label_set_text(battery_label_, battery_icon_);
+            battery_icon = levels[battery_level / 20];
         }
     }
 
-    // 升级固件时，不读取 4G 网络状态，避免占用 UART 资源
+    // 升级固件时，不读取 4G 网络状态，避免占用 UART 资源；其余时间每隔几秒查询一次
+    const char* network_icon = network_icon_;
     auto device_state = Application::GetInstance().GetDeviceState();
     static const std::vector<DeviceState> allowed_states = {
         kDeviceStateIdle,
@@ -147,63 +176,89 @@ void Display::Update() {
         kDeviceStateWifiConfiguring,
         kDeviceStateListening,
     };
-    if (std::find(allowed_states.begin(), allowed_states.end(), device_state) != allowed_states.end()) {
-        icon = board.GetNetworkStateIcon();
-        if (network_label_ != nullptr && network_icon_ != icon) {
-            DisplayLockGuard lock(this);
-            network_icon_ = icon;
-            lv_label_set_text(network_label_, network_icon_);
-        }
+    if (std::find(allowed_states.begin(), allowed_states.end(), device_state) != allowed_states.end() &&
+        update_count_ % DISPLAY_NETWORK_POLL_INTERVAL_S == 0) {
+        network_icon = board.GetNetworkStateIcon();
+    }
+    update_count_++;
+
+    if (muted == muted_ && battery_icon == battery_icon_ && network_icon == network_icon_) {
+        return;
+    }
+
+    DisplayLockGuard lock(this);
+    uint32_t pixels = 0;
+    if (muted != muted_) {
+        muted_ = muted;
+        pixels += SetLabelText(mute_label_, muted_ ? FONT_AWESOME_VOLUME_MUTE : "");
+    }
+    if (battery_icon != battery_icon_) {
+        battery_icon_ = battery_icon;
+        pixels += SetLabelText(battery_label_, battery_icon_);
+    }
+    if (network_icon != network_icon_) {
+        network_icon_ = network_icon;
+        pixels += SetLabelText(network_label_, network_icon_);
     }
+    render_stats_.status_bar_updates++;
+    render_stats_.status_bar_pixels += pixels;
+    ESP_LOGD(TAG, "Status bar invalidated %lu px", pixels);
 }
 
+uint32_t Display::SetLabelText(lv_obj_t* label, const char* text) {
+    if (label == nullptr || strcmp(lv_label_get_text(label), text) == 0) {
+        return 0;
+    }
+    lv_area_t before, after;
+    lv_obj_get_coords(label, &before);
+    lv_label_set_text(label, text);
+    // 立即排版得到新文本的区域，空标签变为图标时旧区域为空，只统计旧区域会得到 0
+    lv_obj_update_layout(label);
+    lv_obj_get_coords(label, &after);
+
+    uint32_t pixels = lv_area_get_size(&before) + lv_area_get_size(&after);
+    int32_t overlap_w = std::min(before.x2, after.x2) - std::max(before.x1, after.x1) + 1;
+    int32_t overlap_h = std::min(before.y2, after.y2) - std::max(before.y1, after.y1) + 1;
+    if (overlap_w > 0 && overlap_h > 0) {
+        pixels -= overlap_w * overlap_h;
+    }
+    return pixels;
+}
 
 void Display::SetEmotion(const char* emotion) {
-    struct Emotion {
-        const char* icon;
-        const char* text;
+    // 按 EmotionId 顺序排列
+    static const char* const icons[kEmotionCount] = {
+        FONT_AWESOME_EMOJI_NEUTRAL,
+        FONT_AWESOME_EMOJI_HAPPY,
+        FONT_AWESOME_EMOJI_LAUGHING,
+        FONT_AWESOME_EMOJI_FUNNY,
+        FONT_AWESOME_EMOJI_SAD,
+        FONT_AWESOME_EMOJI_ANGRY,
+        FONT_AWESOME_EMOJI_CRYING,
+        FONT_AWESOME_EMOJI_LOVING,
+        FONT_AWESOME_EMOJI_EMBARRASSED,
+        FONT_AWESOME_EMOJI_SURPRISED,
+        FONT_AWESOME_EMOJI_SHOCKED,
+        FONT_AWESOME_EMOJI_THINKING,
+        FONT_AWESOME_EMOJI_WINKING,
+        FONT_AWESOME_EMOJI_COOL,
+        FONT_AWESOME_EMOJI_RELAXED,
+        FONT_AWESOME_EMOJI_DELICIOUS,
+        FONT_AWESOME_EMOJI_KISSY,
+        FONT_AWESOME_EMOJI_CONFIDENT,
+        FONT_AWESOME_EMOJI_SLEEPY,
+        FONT_AWESOME_EMOJI_SILLY,
+        FONT_AWESOME_EMOJI_CONFUSED,
     };
 
-    static const std::vector<Emotion> emotions = {
-        {FONT_AWESOME_EMOJI_NEUTRAL, "neutral"},
-        {FONT_AWESOME_EMOJI_HAPPY, "happy"},
-        {FONT_AWESOME_EMOJI_LAUGHING, "laughing"},
-        {FONT_AWESOME_EMOJI_FUNNY, "funny"},
-        {FONT_AWESOME_EMOJI_SAD, "sad"},
-        {FONT_AWESOME_EMOJI_ANGRY, "angry"},
-        {FONT_AWESOME_EMOJI_CRYING, "crying"},
-        {FONT_AWESOME_EMOJI_LOVING, "loving"},
-        {FONT_AWESOME_EMOJI_EMBARRASSED, "embarrassed"},
-        {FONT_AWESOME_EMOJI_SURPRISED, "surprised"},
-        {FONT_AWESOME_EMOJI_SHOCKED, "shocked"},
-        {FONT_AWESOME_EMOJI_THINKING, "thinking"},
-        {FONT_AWESOME_EMOJI_WINKING, "winking"},
-        {FONT_AWESOME_EMOJI_COOL, "cool"},
-        {FONT_AWESOME_EMOJI_RELAXED, "relaxed"},
-        {FONT_AWESOME_EMOJI_DELICIOUS, "delicious"},
-        {FONT_AWESOME_EMOJI_KISSY, "kissy"},
-        {FONT_AWESOME_EMOJI_CONFIDENT, "confident"},
-        {FONT_AWESOME_EMOJI_SLEEPY, "sleepy"},
-        {FONT_AWESOME_EMOJI_SILLY, "silly"},
-        {FONT_AWESOME_EMOJI_CONFUSED, "confused"}
-    };
-    
-    // 查找匹配的表情
-    std::string_view emotion_view(emotion);
-    auto it = std::find_if(emotions.begin(), emotions.end(),
-        [&emotion_view](const Emotion& e) { return e.text == emotion_view; });
-    
+    // 未知的表情显示 neutral
+    auto id = GetEmotionId(emotion);
+
     DisplayLockGuard lock(this);
     if (emotion_label_ == nullptr) {
         return;
     }
-
-    // 如果找到匹配的表情就显示对应图标，否则显示默认的neutral表情
-    if (it != emotions.end()) {
-        lv_label_set_text(emotion_label_, it->icon);
-    } else {
-        lv_label_set_text(emotion_label_, FONT_AWESOME_EMOJI_NEUTRAL);
-    }
+    SetLabelText(emotion_label_, icons[id]);
 }
 
 void Display::SetIcon(const char* icon) {
@@ -222,8 +277,183 @@ void Display::SetChatMessage(const char* role, const char* content) {
     lv_label_set_text(chat_message_label_, content);
 }
 
+void Display::PostStatus(const char* status) {
+    if (update_queue_.PostStatus(status)) {
+        StartCoalesceTimer();
+    }
+}
+
+void Display::PostEmotion(const char* emotion) {
+    if (update_queue_.PostEmotion(emotion)) {
+        StartCoalesceTimer();
+    }
+}
+
+void Display::PostIcon(const char* icon) {
+    if (update_queue_.PostIcon(icon)) {
+        StartCoalesceTimer();
+    }
+}
+
+void Display::PostChatMessage(const char* role, const char* content) {
+    if (update_queue_.PostChatMessage(role, content)) {
+        StartCoalesceTimer();
+    }
+}
+
+// 第一条待处理的更新启动定时器，后续更新在同一帧内合并
+void Display::StartCoalesceTimer() {
+    esp_timer_start_once(coalesce_timer_, DISPLAY_FRAME_INTERVAL_MS * 1000);
+}
+
+void Display::ApplyPendingUpdates() {
+    auto updates = update_queue_.Take();
+
+    // 整帧的更新只加锁一次，Set* 内部再次加锁是递归的
+    DisplayLockGuard lock(this);
+    if (updates.kinds & DisplayUpdateQueue::kStatus) {
+        SetStatus(updates.status.c_str());
+        updates_applied_++;
+    }
+    if (updates.kinds & DisplayUpdateQueue::kEmotion) {
+        if (updates.emotion_is_icon) {
+            SetIcon(updates.emotion.c_str());
+        } else {
+            SetEmotion(updates.emotion.c_str());
+        }
+        updates_applied_++;
+    }
+    for (auto& message : updates.chat_messages) {
+        SetChatMessage(message.first.c_str(), message.second.c_str());
+        updates_applied_++;
+    }
+}
+
+void Display::InitializeRenderStats() {
+#if CONFIG_USE_DISPLAY_RENDER_STATS
+    auto callback = [](lv_event_t* e) {
+        auto display = static_cast<Display*>(lv_event_get_user_data(e));
+        auto& stats = display->render_stats_;
+        switch (lv_event_get_code(e)) {
+            case LV_EVENT_REFR_START:
+                stats.frame_start_us = esp_timer_get_time();
+                stats.frame_flushes = 0;
+                break;
+            case LV_EVENT_FLUSH_START: {
+                auto area = static_cast<const lv_area_t*>(lv_event_get_param(e));
+                stats.flushes++;
+                stats.frame_flushes++;
+                stats.dirty_pixels += lv_area_get_size(area);
+                break;
+            }
+            case LV_EVENT_REFR_READY:
+                // 没有脏区的刷新周期不计入帧数
+                if (stats.frame_flushes > 0) {
+                    int64_t render_time_us = esp_timer_get_time() - stats.frame_start_us;
+                    stats.frames++;
+                    stats.render_time_us += render_time_us;
+                    if (render_time_us > stats.max_render_time_us) {
+                        stats.max_render_time_us = render_time_us;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    };
+    lv_display_add_event_cb(display_, callback, LV_EVENT_REFR_START, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_FLUSH_START, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_REFR_READY, this);
+#endif
+}
+
+void Display::InitializeIdleSuspend() {
+#if CONFIG_USE_DISPLAY_IDLE_SUSPEND
+    auto callback = [](lv_event_t* e) {
+        auto display = static_cast<Display*>(lv_event_get_user_data(e));
+        auto refr_timer = lv_display_get_refr_timer(display->display_);
+        if (lv_event_get_code(e) == LV_EVENT_REFR_READY) {
+            // 画面静止时不再按刷新周期唤醒 LVGL 任务，有动画时保持正常帧率
+            if (!display->render_suspended_ && lv_anim_count_running() == 0) {
+                display->render_suspended_ = true;
+                lv_timer_pause(refr_timer);
+            }
+        } else if (display->render_suspended_) {
+            display->render_suspended_ = false;
+            lv_timer_resume(refr_timer);
+            display->render_wake_pending_ = true;
+        }
+    };
+    lv_display_add_event_cb(display_, callback, LV_EVENT_REFR_READY, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_INVALIDATE_AREA, this);
+#endif
+}
+
+// 其他任务修改界面后，LVGL 任务可能还在长时间休眠，解锁后立即唤醒它
+void Display::WakeRenderer() {
+#if CONFIG_USE_DISPLAY_IDLE_SUSPEND
+    if (render_wake_pending_.exchange(false)) {
+        lvgl_port_task_wake(LVGL_PORT_EVENT_USER, nullptr);
+    }
+#endif
+}
+
+void Display::LogRenderStats(const char* label) {
+#if CONFIG_USE_DISPLAY_RENDER_STATS
+    RenderStats stats;
+    {
+        DisplayLockGuard lock(this);
+        stats = render_stats_;
+        render_stats_ = {};
+    }
+    if (stats.frames == 0) {
+        ESP_LOGI(TAG, "%s: no frames", label);
+    } else {
+        ESP_LOGI(TAG, "%s: %lu frames, %lu flushes, %llu px/frame, avg %lld us max %lld us per frame",
+            label, stats.frames, stats.flushes, stats.dirty_pixels / stats.frames,
+            stats.render_time_us / stats.frames, stats.max_render_time_us);
+    }
+    if (stats.status_bar_updates > 0) {
+        ESP_LOGI(TAG, "%s: status bar %lu updates, %llu px invalidated", label,
+            stats.status_bar_updates, stats.status_bar_pixels);
+    }
+#endif
+}
+
 void Display::SetBacklight(uint8_t brightness) {
     Settings settings("display", true);
     settings.SetInt("brightness", brightness);
     brightness_ = brightness;
 }
+
+void Display::OnDeviceStateChanged(DeviceState state) {
+#if CONFIG_USE_BACKLIGHT_AUTO_DIM
+    if (dim_timer_ == nullptr) {
+        return;
+    }
+    esp_timer_stop(dim_timer_);
+    if (state == kDeviceStateIdle) {
+        esp_timer_start_once(dim_timer_, CONFIG_BACKLIGHT_DIM_TIMEOUT_S * 1000000LL);
+        return;
+    }
+    // 配网、激活、对话等状态需要看屏幕，立即恢复亮度
+    if (backlight_level_.exchange(kBacklightNormal) != kBacklightNormal) {
+        ApplyBacklight(brightness_);
+    }
+#endif
+}
+
+void Display::OnDimTimer() {
+#if CONFIG_USE_BACKLIGHT_AUTO_DIM
+    if (backlight_level_ == kBacklightNormal) {
+        backlight_level_ = kBacklightDimmed;
+        ApplyBacklight(std::min<uint8_t>(brightness_, CONFIG_BACKLIGHT_DIM_BRIGHTNESS));
+        if (CONFIG_BACKLIGHT_OFF_TIMEOUT_S > 0) {
+            esp_timer_start_once(dim_timer_, CONFIG_BACKLIGHT_OFF_TIMEOUT_S * 1000000LL);
+        }
+    } else if (backlight_level_ == kBacklightDimmed) {
+        backlight_level_ = kBacklightOff;
+        ApplyBacklight(0);
+    }
+#endif
+}
@@ -5,7 +5,19 @@
 #include <esp_timer.h>
 #include <esp_log.h>
 
+#include "device_state_machine.h"
+#include "display_update_queue.h"
+
 #include <string>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+// 状态栏查询网络状态的间隔，4G 模组需要通过 UART 查询信号强度
+#define DISPLAY_NETWORK_POLL_INTERVAL_S 5
+
+// 合并界面更新的间隔，与 LVGL 默认的刷新周期一致
+#define DISPLAY_FRAME_INTERVAL_MS 33
 
 struct DisplayFonts {
     const lv_font_t* text_font = nullptr;
@@ -25,6 +37,20 @@ public:
     virtual void SetChatMessage(const char* role, const char* content);
     virtual void SetIcon(const char* icon);
     virtual void SetBacklight(uint8_t brightness);
+    // 空闲一段时间后自动调暗、关闭背光，离开空闲状态时恢复，不修改保存的亮度
+    void OnDeviceStateChanged(DeviceState state);
+
+    // 可在任意任务中调用，同类更新只保留最新的一次，每个显示帧最多应用一次
+    // 状态、表情、图标和聊天消息应统一通过 Post* 更新，直接调用 Set* 会被之后应用的旧的待处理值覆盖
+    void PostStatus(const char* status);
+    void PostEmotion(const char* emotion);
+    // 图标与表情共用同一个标签，按同一类更新合并
+    void PostIcon(const char* icon);
+    void PostChatMessage(const char* role, const char* content);
+    inline uint32_t updates_received() const { return update_queue_.received(); }
+    inline uint32_t updates_applied() const { return updates_applied_; }
+    // 打印上次调用以来的渲染统计并清零，未启用 CONFIG_USE_DISPLAY_RENDER_STATS 时不输出
+    virtual void LogRenderStats(const char* label = "Render");
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
@@ -47,15 +73,60 @@ protected:
     const char* battery_icon_ = nullptr;
     const char* network_icon_ = nullptr;
     bool muted_ = false;
+    uint32_t update_count_ = 0;
 
     esp_timer_handle_t notification_timer_ = nullptr;
     esp_timer_handle_t update_timer_ = nullptr;
+    esp_timer_handle_t coalesce_timer_ = nullptr;
+
+    enum BacklightLevel {
+        kBacklightNormal,
+        kBacklightDimmed,
+        kBacklightOff,
+    };
+    std::atomic<BacklightLevel> backlight_level_{kBacklightNormal};
+    esp_timer_handle_t dim_timer_ = nullptr;
+    void OnDimTimer();
+    // 只改变实际输出的亮度，不保存设置；没有可调背光的屏幕不需要实现
+    virtual void ApplyBacklight(uint8_t brightness) {}
+
+    DisplayUpdateQueue update_queue_;
+    uint32_t updates_applied_ = 0;
+
+    struct RenderStats {
+        uint32_t frames;
+        uint32_t flushes;
+        uint64_t dirty_pixels;
+        int64_t render_time_us;
+        int64_t max_render_time_us;
+        int64_t frame_start_us;
+        uint32_t frame_flushes;
+        // 状态栏图标变化的次数和因此需要重绘的像素数
+        uint32_t status_bar_updates;
+        uint64_t status_bar_pixels;
+    };
+    RenderStats render_stats_ = {};
+
+    // 在 display_ 创建后调用，注册 LVGL 刷新事件用于渲染统计
+    void InitializeRenderStats();
+
+    // 没有脏区和动画时暂停 LVGL 刷新定时器，出现新的脏区时恢复
+    std::atomic<bool> render_wake_pending_{false};
+    bool render_suspended_ = false;
+    void InitializeIdleSuspend();
+    void WakeRenderer();
 
     friend class DisplayLockGuard;
     virtual bool Lock(int timeout_ms = 0) = 0;
     virtual void Unlock() = 0;
 
     virtual void Update();
+    // 文本不变时跳过，避免重新排版和重绘；返回新旧文本区域合起来需要重绘的像素数
+    uint32_t SetLabelText(lv_obj_t* label, const char* text);
+
+private:
+    void StartCoalesceTimer();
+    void ApplyPendingUpdates();
 };
 
 
@@ -68,6 +139,7 @@ public:
     }
     ~DisplayLockGuard() {
         display_->Unlock();
+        display_->WakeRenderer();
     }
 
 private:
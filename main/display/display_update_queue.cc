@@ -0,0 +1,46 @@
+#include "display_update_queue.h"
+
+#include <cstring>
+
+bool DisplayUpdateQueue::PostStatus(const char* status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.status = status;
+    return Mark(kStatus);
+}
+
+bool DisplayUpdateQueue::PostEmotion(const char* emotion) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.emotion = emotion;
+    pending_.emotion_is_icon = false;
+    return Mark(kEmotion);
+}
+
+bool DisplayUpdateQueue::PostIcon(const char* icon) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.emotion = icon;
+    pending_.emotion_is_icon = true;
+    return Mark(kEmotion);
+}
+
+bool DisplayUpdateQueue::PostChatMessage(const char* role, const char* content) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (content[0] == '\0' || strcmp(role, "system") == 0) {
+        pending_.chat_messages.clear();
+    }
+    pending_.chat_messages.emplace_back(role, content);
+    return Mark(kChatMessage);
+}
+
+bool DisplayUpdateQueue::Mark(Kind kind) {
+    received_++;
+    bool first = pending_.kinds == 0;
+    pending_.kinds |= kind;
+    return first;
+}
+
+DisplayUpdateQueue::Updates DisplayUpdateQueue::Take() {
+    Updates updates;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(updates, pending_);
+    return updates;
+}
@@ -0,0 +1,48 @@
+#ifndef DISPLAY_UPDATE_QUEUE_H
+#define DISPLAY_UPDATE_QUEUE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 各任务提交的界面更新，由显示帧定时器统一取出应用
+// 状态和表情同类只保留最新的一次；图标与表情共用同一个标签，按同一类合并，后提交的生效；
+// 聊天区按条追加，同一帧内的多条消息都要保留，系统消息或清空会丢弃之前未应用的消息
+class DisplayUpdateQueue {
+public:
+    enum Kind {
+        kStatus = 1 << 0,
+        kEmotion = 1 << 1,
+        kChatMessage = 1 << 2,
+    };
+
+    struct Updates {
+        uint8_t kinds = 0;
+        std::string status;
+        std::string emotion;
+        bool emotion_is_icon = false;
+        std::vector<std::pair<std::string, std::string>> chat_messages;
+    };
+
+    // 可在任意任务中调用，返回 true 表示这是本帧第一条待处理的更新，调用者需要启动帧定时器
+    bool PostStatus(const char* status);
+    bool PostEmotion(const char* emotion);
+    bool PostIcon(const char* icon);
+    bool PostChatMessage(const char* role, const char* content);
+
+    // 取出全部待处理的更新并清空
+    Updates Take();
+    inline uint32_t received() const { return received_; }
+
+private:
+    std::mutex mutex_;
+    Updates pending_;
+    uint32_t received_ = 0;
+
+    // 调用者需持有 mutex_
+    bool Mark(Kind kind);
+};
+
+#endif // DISPLAY_UPDATE_QUEUE_H
@@ -0,0 +1,114 @@
+#include "emotion_sprites.h"
+
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "EmotionSprites"
+
+EmotionSprites::~EmotionSprites() {
+    if (mmap_handle_ != 0) {
+        esp_partition_munmap(mmap_handle_);
+    }
+}
+
+bool EmotionSprites::Load(int max_width, int max_height) {
+    auto partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, EMOTION_SPRITES_PARTITION);
+    if (partition == nullptr) {
+        return false;
+    }
+
+    EmotionSpritesHeader header;
+    if (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK ||
+        header.magic != EMOTION_SPRITES_MAGIC || header.version != EMOTION_SPRITES_VERSION) {
+        ESP_LOGW(TAG, "No emotion sprites in partition %s", partition->label);
+        return false;
+    }
+    if (header.width > max_width || header.height > max_height) {
+        ESP_LOGW(TAG, "Sprite size %ux%u exceeds display", header.width, header.height);
+        return false;
+    }
+
+    // 先读出条目表，只映射实际用到的帧数据，分区剩余空间不占用 MMU 页
+    int count = header.emotion_count < kEmotionCount ? header.emotion_count : kEmotionCount;
+    EmotionSpritesEntry entries[kEmotionCount];
+    if (esp_partition_read(partition, sizeof(header), entries, count * sizeof(EmotionSpritesEntry)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read emotion entries");
+        return false;
+    }
+    uint32_t frame_size = header.width * header.height * 3;
+    uint64_t mapped_size = 0;
+    int total_frames = 0;
+    for (int i = 0; i < count; i++) {
+        if (entries[i].frame_count == 0) {
+            continue;
+        }
+        uint64_t end = entries[i].offset + (uint64_t)entries[i].frame_count * frame_size;
+        if (end > partition->size) {
+            ESP_LOGE(TAG, "Emotion %s exceeds partition", GetEmotionName((EmotionId)i));
+            return false;
+        }
+        if (end > mapped_size) {
+            mapped_size = end;
+        }
+        total_frames += entries[i].frame_count;
+    }
+    if (total_frames == 0) {
+        ESP_LOGW(TAG, "No emotion sprite frames in partition %s", partition->label);
+        return false;
+    }
+
+    const void* base = nullptr;
+    if (esp_partition_mmap(partition, 0, mapped_size, ESP_PARTITION_MMAP_DATA, &base, &mmap_handle_) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mmap partition %s", partition->label);
+        mmap_handle_ = 0;
+        return false;
+    }
+
+    // 图像描述符只保存指向 flash 映射区的指针，每帧约 30 字节
+    frames_.reserve(total_frames);
+    for (int i = 0; i < count; i++) {
+        auto& emotion = emotions_[i];
+        emotion.first_frame = frames_.size();
+        emotion.frame_count = entries[i].frame_count;
+        emotion.frame_interval_ms = entries[i].frame_interval_ms > 0 ? entries[i].frame_interval_ms : 100;
+        for (int f = 0; f < emotion.frame_count; f++) {
+            lv_image_dsc_t dsc;
+            memset(&dsc, 0, sizeof(dsc));
+            dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+            dsc.header.cf = LV_COLOR_FORMAT_RGB565A8;
+            dsc.header.w = header.width;
+            dsc.header.h = header.height;
+            dsc.header.stride = header.width * 2;
+            dsc.data_size = frame_size;
+            dsc.data = static_cast<const uint8_t*>(base) + entries[i].offset + f * frame_size;
+            frames_.push_back(dsc);
+        }
+    }
+
+    ESP_LOGI(TAG, "Loaded %d frames of %ux%u, %u KB mapped, %u bytes descriptors", total_frames,
+        header.width, header.height, (unsigned)(mapped_size / 1024), (unsigned)(total_frames * sizeof(lv_image_dsc_t)));
+    return true;
+}
+
+int EmotionSprites::frame_count(EmotionId id) const {
+    if (!loaded() || id < 0 || id >= kEmotionCount) {
+        return 0;
+    }
+    return emotions_[id].frame_count;
+}
+
+int EmotionSprites::frame_interval_ms(EmotionId id) const {
+    if (frame_count(id) == 0) {
+        return 0;
+    }
+    return emotions_[id].frame_interval_ms;
+}
+
+// 没有精灵图的表情返回 nullptr
+const lv_image_dsc_t* EmotionSprites::GetFrame(EmotionId id, int frame) const {
+    if (frame_count(id) == 0 || frame < 0) {
+        return nullptr;
+    }
+    auto& emotion = emotions_[id];
+    return &frames_[emotion.first_frame + frame % emotion.frame_count];
+}
@@ -0,0 +1,58 @@
+#ifndef EMOTION_SPRITES_H
+#define EMOTION_SPRITES_H
+
+#include <lvgl.h>
+#include <esp_partition.h>
+
+#include <vector>
+
+#include "emotions.h"
+
+#define EMOTION_SPRITES_PARTITION "emotions"
+#define EMOTION_SPRITES_MAGIC 0x534f4d45 // "EMOS"
+#define EMOTION_SPRITES_VERSION 1
+
+// 分区布局（小端），由 scripts/pack_emotion_sprites.py 生成：
+//   EmotionSpritesHeader
+//   EmotionSpritesEntry[emotion_count]，按 EmotionId 顺序，frame_count 为 0 表示使用字体表情
+//   帧数据，每帧为 RGB565 平面加 A8 平面（LV_COLOR_FORMAT_RGB565A8）
+struct EmotionSpritesHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t emotion_count;
+    uint16_t width;
+    uint16_t height;
+    uint32_t reserved;
+} __attribute__((packed));
+
+struct EmotionSpritesEntry {
+    uint32_t offset;            // 第一帧相对分区起始的偏移
+    uint16_t frame_count;
+    uint16_t frame_interval_ms;
+} __attribute__((packed));
+
+// 预先光栅化的多帧表情，帧数据通过 mmap 直接从 flash 读取，不占用 RAM
+class EmotionSprites {
+public:
+    ~EmotionSprites();
+
+    // 分区不存在或格式不符时返回 false，调用者继续使用字体表情
+    bool Load(int max_width, int max_height);
+    inline bool loaded() const { return mmap_handle_ != 0; }
+
+    int frame_count(EmotionId id) const;
+    int frame_interval_ms(EmotionId id) const;
+    const lv_image_dsc_t* GetFrame(EmotionId id, int frame) const;
+
+private:
+    esp_partition_mmap_handle_t mmap_handle_ = 0;
+    struct Emotion {
+        int first_frame;
+        int frame_count;
+        int frame_interval_ms;
+    };
+    Emotion emotions_[kEmotionCount] = {};
+    std::vector<lv_image_dsc_t> frames_;
+};
+
+#endif // EMOTION_SPRITES_H
@@ -0,0 +1,67 @@
+#include "emotions.h"
+#include "fnv_hash.h"
+
+#include <cstdint>
+#include <cstring>
+
+static const char* const EMOTION_NAMES[] = {
+    "neutral",
+    "happy",
+    "laughing",
+    "funny",
+    "sad",
+    "angry",
+    "crying",
+    "loving",
+    "embarrassed",
+    "surprised",
+    "shocked",
+    "thinking",
+    "winking",
+    "cool",
+    "relaxed",
+    "delicious",
+    "kissy",
+    "confident",
+    "sleepy",
+    "silly",
+    "confused",
+};
+static_assert(sizeof(EMOTION_NAMES) / sizeof(EMOTION_NAMES[0]) == kEmotionCount, "EMOTION_NAMES mismatch");
+
+EmotionId GetEmotionId(const char* name) {
+    EmotionId id;
+    switch (FnvHash(name)) {
+        case FnvHash("neutral"): id = kEmotionNeutral; break;
+        case FnvHash("happy"): id = kEmotionHappy; break;
+        case FnvHash("laughing"): id = kEmotionLaughing; break;
+        case FnvHash("funny"): id = kEmotionFunny; break;
+        case FnvHash("sad"): id = kEmotionSad; break;
+        case FnvHash("angry"): id = kEmotionAngry; break;
+        case FnvHash("crying"): id = kEmotionCrying; break;
+        case FnvHash("loving"): id = kEmotionLoving; break;
+        case FnvHash("embarrassed"): id = kEmotionEmbarrassed; break;
+        case FnvHash("surprised"): id = kEmotionSurprised; break;
+        case FnvHash("shocked"): id = kEmotionShocked; break;
+        case FnvHash("thinking"): id = kEmotionThinking; break;
+        case FnvHash("winking"): id = kEmotionWinking; break;
+        case FnvHash("cool"): id = kEmotionCool; break;
+        case FnvHash("relaxed"): id = kEmotionRelaxed; break;
+        case FnvHash("delicious"): id = kEmotionDelicious; break;
+        case FnvHash("kissy"): id = kEmotionKissy; break;
+        case FnvHash("confident"): id = kEmotionConfident; break;
+        case FnvHash("sleepy"): id = kEmotionSleepy; break;
+        case FnvHash("silly"): id = kEmotionSilly; break;
+        case FnvHash("confused"): id = kEmotionConfused; break;
+        default: return kEmotionNeutral;
+    }
+    // 哈希命中后再比较一次，避免未知名称因冲突被误识别
+    return strcmp(EMOTION_NAMES[id], name) == 0 ? id : kEmotionNeutral;
+}
+
+const char* GetEmotionName(EmotionId id) {
+    if (id < 0 || id >= kEmotionCount) {
+        return EMOTION_NAMES[kEmotionNeutral];
+    }
+    return EMOTION_NAMES[id];
+}
@@ -0,0 +1,34 @@
+#ifndef EMOTIONS_H
+#define EMOTIONS_H
+
+// 服务器 llm 消息中 emotion 字段的取值，顺序与表情精灵图分区中的条目一致
+enum EmotionId {
+    kEmotionNeutral,
+    kEmotionHappy,
+    kEmotionLaughing,
+    kEmotionFunny,
+    kEmotionSad,
+    kEmotionAngry,
+    kEmotionCrying,
+    kEmotionLoving,
+    kEmotionEmbarrassed,
+    kEmotionSurprised,
+    kEmotionShocked,
+    kEmotionThinking,
+    kEmotionWinking,
+    kEmotionCool,
+    kEmotionRelaxed,
+    kEmotionDelicious,
+    kEmotionKissy,
+    kEmotionConfident,
+    kEmotionSleepy,
+    kEmotionSilly,
+    kEmotionConfused,
+    kEmotionCount
+};
+
+// 未知的名称返回 kEmotionNeutral
+EmotionId GetEmotionId(const char* name);
+const char* GetEmotionName(EmotionId id);
+
+#endif // EMOTIONS_H
@@ -0,0 +1,98 @@
+#include "glyph_cache.h"
+
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "GlyphCache"
+
+GlyphCache::GlyphCache(const lv_font_t* base, size_t capacity) : base_(base), capacity_(capacity) {
+    // 复制原字体的度量和回退字体，只替换两个回调
+    font_ = *base;
+    font_.get_glyph_dsc = GetGlyphDsc;
+    font_.get_glyph_bitmap = GetGlyphBitmap;
+    font_.user_data = this;
+}
+
+GlyphCache::~GlyphCache() {
+    for (auto& entry : lru_) {
+        heap_caps_free(entry.bitmap);
+    }
+}
+
+bool GlyphCache::GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next) {
+    auto cache = static_cast<const GlyphCache*>(font->user_data);
+    return cache->base_->get_glyph_dsc(cache->base_, dsc, letter, letter_next);
+}
+
+const void* GlyphCache::GetGlyphBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    auto cache = static_cast<GlyphCache*>(dsc->resolved_font->user_data);
+    return cache->GetBitmap(dsc, draw_buf);
+}
+
+// 在 LVGL 任务中调用，不需要额外加锁
+const void* GlyphCache::GetBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf) {
+    // 只缓存展开到 draw_buf 中的 A1~A8 位图字形
+    bool cacheable = draw_buf != nullptr &&
+        dsc->format > LV_FONT_GLYPH_FORMAT_NONE && dsc->format < LV_FONT_GLYPH_FORMAT_IMAGE;
+    uint32_t glyph_id = dsc->gid.index;
+
+    if (cacheable) {
+        auto it = entries_.find(glyph_id);
+        if (it != entries_.end()) {
+            hits_++;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            auto& entry = *it->second;
+            uint32_t stride = draw_buf->header.stride;
+            for (int y = 0; y < entry.height; y++) {
+                memcpy(draw_buf->data + y * stride, entry.bitmap + y * entry.width, entry.width);
+            }
+            return draw_buf;
+        }
+        misses_++;
+    }
+
+    dsc->resolved_font = base_;
+    auto result = base_->get_glyph_bitmap(dsc, draw_buf);
+    dsc->resolved_font = &font_;
+    if (cacheable && result == draw_buf) {
+        Insert(glyph_id, dsc->box_w, dsc->box_h, draw_buf);
+    }
+    return result;
+}
+
+void GlyphCache::Insert(uint32_t glyph_id, uint16_t width, uint16_t height, const lv_draw_buf_t* draw_buf) {
+    size_t size = width * height;
+    if (size == 0 || size > capacity_) {
+        return;
+    }
+    while (used_ + size > capacity_ && !lru_.empty()) {
+        auto& entry = lru_.back();
+        used_ -= entry.width * entry.height;
+        heap_caps_free(entry.bitmap);
+        entries_.erase(entry.glyph_id);
+        lru_.pop_back();
+    }
+
+    auto bitmap = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM));
+    if (bitmap == nullptr) {
+        bitmap = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_DEFAULT));
+        if (bitmap == nullptr) {
+            return;
+        }
+    }
+    uint32_t stride = draw_buf->header.stride;
+    for (int y = 0; y < height; y++) {
+        memcpy(bitmap + y * width, draw_buf->data + y * stride, width);
+    }
+    lru_.push_front(Entry{glyph_id, width, height, bitmap});
+    entries_[glyph_id] = lru_.begin();
+    used_ += size;
+}
+
+void GlyphCache::LogStats() {
+    uint32_t total = hits_ + misses_;
+    ESP_LOGI(TAG, "%u glyphs, %u/%u KB, hit rate %lu%% (%lu hits, %lu misses)",
+        (unsigned)entries_.size(), (unsigned)(used_ / 1024), (unsigned)(capacity_ / 1024),
+        total > 0 ? hits_ * 100 / total : 0, hits_, misses_);
+}
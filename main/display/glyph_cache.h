@@ -0,0 +1,44 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <lvgl.h>
+
+#include <list>
+#include <unordered_map>
+
+// 包装 LVGL 字体的字形位图缓存
+// 中文字体的字形每次绘制都要从 4bpp/压缩格式展开成 A8，缓存展开后的位图（优先放在 PSRAM），
+// 按最近最少使用淘汰。字形描述和度量直接转发给原字体
+class GlyphCache {
+public:
+    GlyphCache(const lv_font_t* base, size_t capacity);
+    ~GlyphCache();
+
+    // 用于替换原字体的包装字体，生命周期与缓存相同
+    inline const lv_font_t* font() const { return &font_; }
+    void LogStats();
+
+private:
+    struct Entry {
+        uint32_t glyph_id;
+        uint16_t width;
+        uint16_t height;
+        uint8_t* bitmap;
+    };
+
+    lv_font_t font_;
+    const lv_font_t* base_;
+    size_t capacity_;
+    size_t used_ = 0;
+    std::list<Entry> lru_;
+    std::unordered_map<uint32_t, std::list<Entry>::iterator> entries_;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+
+    static bool GetGlyphDsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next);
+    static const void* GetGlyphBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf);
+    const void* GetBitmap(lv_font_glyph_dsc_t* dsc, lv_draw_buf_t* draw_buf);
+    void Insert(uint32_t glyph_id, uint16_t width, uint16_t height, const lv_draw_buf_t* draw_buf);
+};
+
+#endif // GLYPH_CACHE_H
@@ -5,7 +5,11 @@
 #include <esp_err.h>
 #include <driver/ledc.h>
 #include <vector>
+#include <cstring>
+#include <cmath>
+#include <cstdlib>
 #include <esp_lvgl_port.h>
+#include "lvgl_port_config.h"
 #include <esp_timer.h>
 #include "assets/lang_config.h"
 
@@ -13,29 +17,21 @@
 
 #define TAG "LcdDisplay"
 #define LCD_LEDC_CH LEDC_CHANNEL_0
+// LEDC 分辨率为 10 位
+#define LCD_LEDC_MAX_DUTY 1023
+#define LCD_BACKLIGHT_FADE_MS 500
+#define LCD_BACKLIGHT_GAMMA 2.2f
 
 LV_FONT_DECLARE(font_awesome_30_4);
 
 SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                            gpio_num_t backlight_pin, bool backlight_output_invert,
                            int width, int height, int offset_x, int offset_y, bool mirror_x, bool mirror_y, bool swap_xy,
-                           DisplayFonts fonts)
+                           DisplayFonts fonts, DisplayBufferConfig buffer_config)
     : LcdDisplay(panel_io, panel, backlight_pin, backlight_output_invert, fonts) {
     width_ = width;
     height_ = height;
 
-    // 创建背光渐变定时器
-    const esp_timer_create_args_t timer_args = {
-        .callback = [](void* arg) {
-            LcdDisplay* display = static_cast<LcdDisplay*>(arg);
-            display->OnBacklightTimer();
-        },
-        .arg = this,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "backlight_timer",
-        .skip_unhandled_events = true,
-    };
-    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &backlight_timer_));
     InitializeBacklight(backlight_pin);
 
     // draw white
@@ -52,17 +48,20 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     lv_init();
 
     ESP_LOGI(TAG, "Initialize LVGL port");
-    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_cfg_t port_cfg = GetLvglPortConfig();
     lvgl_port_init(&port_cfg);
 
-    ESP_LOGI(TAG, "Adding LCD screen");
+    int buffer_lines = buffer_config.lines > 0 && buffer_config.lines < height_ ? buffer_config.lines : height_;
+    ESP_LOGI(TAG, "Adding LCD screen, draw buffer %d lines x%d in %s", buffer_lines,
+        buffer_config.double_buffer ? 2 : 1, buffer_config.spiram ? "PSRAM" : "DMA RAM");
     const lvgl_port_display_cfg_t display_cfg = {
         .io_handle = panel_io_,
         .panel_handle = panel_,
         .control_handle = nullptr,
-        .buffer_size = static_cast<uint32_t>(width_ * 10),
-        .double_buffer = false,
-        .trans_size = 0,
+        .buffer_size = static_cast<uint32_t>(width_ * buffer_lines),
+        .double_buffer = buffer_config.double_buffer,
+        // PSRAM 缓冲区不能直接 DMA，按 10 行一块复制到内部 RAM 后发送
+        .trans_size = buffer_config.spiram ? static_cast<uint32_t>(width_ * 10) : 0,
         .hres = static_cast<uint32_t>(width_),
         .vres = static_cast<uint32_t>(height_),
         .monochrome = false,
@@ -73,8 +72,8 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         },
         .color_format = LV_COLOR_FORMAT_RGB565,
         .flags = {
-            .buff_dma = 1,
-            .buff_spiram = 0,
+            .buff_dma = !buffer_config.spiram,
+            .buff_spiram = buffer_config.spiram,
             .sw_rotate = 0,
             .swap_bytes = 1,
             .full_refresh = 0,
@@ -88,6 +87,9 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         return;
     }
 
+    InitializeRenderStats();
+    InitializeIdleSuspend();
+
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
     }
@@ -107,19 +109,7 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     width_ = width;
     height_ = height;
 
-        // 创建背光渐变定时器
-    const esp_timer_create_args_t timer_args = {
-        .callback = [](void* arg) {
-            LcdDisplay* display = static_cast<LcdDisplay*>(arg);
-            display->OnBacklightTimer();
-        },
-        .arg = this,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "backlight_timer",
-        .skip_unhandled_events = true,
-    };
-    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &backlight_timer_));
-    InitializeBacklight(backlight_pin);
+        InitializeBacklight(backlight_pin);
     
     // draw white
     std::vector<uint16_t> buffer(width_, 0xFFFF);
@@ -131,7 +121,7 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     lv_init();
 
     ESP_LOGI(TAG, "Initialize LVGL port");
-    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_cfg_t port_cfg = GetLvglPortConfig();
     lvgl_port_init(&port_cfg);
 
     ESP_LOGI(TAG, "Adding LCD screen");
@@ -167,6 +157,9 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         ESP_LOGE(TAG, "Failed to add RGB display");
         return;
     }
+
+    InitializeRenderStats();
+    InitializeIdleSuspend();
     
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
@@ -178,9 +171,8 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
 }
 
 LcdDisplay::~LcdDisplay() {
-    if (backlight_timer_ != nullptr) {
-        esp_timer_stop(backlight_timer_);
-        esp_timer_delete(backlight_timer_);
+    if (emotion_timer_ != nullptr) {
+        lv_timer_delete(emotion_timer_);
     }
     // 然后再清理 LVGL 对象
     if (content_ != nullptr) {
@@ -236,23 +228,43 @@ void LcdDisplay::InitializeBacklight(gpio_num_t backlight_pin) {
 
     ESP_ERROR_CHECK(ledc_timer_config(&backlight_timer));
     ESP_ERROR_CHECK(ledc_channel_config(&backlight_channel));
+
+    // 渐变服务全局只需安装一次，其他外设可能已经安装过
+    esp_err_t ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(ret);
+    }
 }
 
-void LcdDisplay::OnBacklightTimer() {
-    if (current_brightness_ < brightness_) {
-        current_brightness_++;
-    } else if (current_brightness_ > brightness_) {
-        current_brightness_--;
+// 人眼对亮度的感知接近幂函数，按 gamma 2.2 把百分比换算成占空比，低亮度区间的调节更均匀
+static uint32_t BrightnessToDuty(uint8_t brightness) {
+    if (brightness == 0) {
+        return 0;
     }
-    
-    // LEDC resolution set to 10bits, thus: 100% = 1023
-    uint32_t duty_cycle = (1023 * current_brightness_) / 100;
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH, duty_cycle);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH);
-    
-    if (current_brightness_ == brightness_) {
-        esp_timer_stop(backlight_timer_);
+    uint32_t duty = static_cast<uint32_t>(powf(brightness / 100.0f, LCD_BACKLIGHT_GAMMA) * LCD_LEDC_MAX_DUTY + 0.5f);
+    return duty > 0 ? duty : 1;
+}
+
+void LcdDisplay::ApplyBacklight(uint8_t brightness) {
+    if (backlight_pin_ == GPIO_NUM_NC) {
+        return;
     }
+    if (brightness > 100) {
+        brightness = 100;
+    }
+
+    // 打断正在进行的渐变，从当前占空比开始新的渐变
+    ledc_fade_stop(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH);
+    uint32_t duty = BrightnessToDuty(brightness);
+    int steps = std::abs(brightness - current_brightness_);
+    ESP_LOGI(TAG, "Backlight fade %d%% -> %d%%, duty %lu", current_brightness_, brightness, duty);
+    ESP_ERROR_CHECK(ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH, duty, LCD_BACKLIGHT_FADE_MS));
+    ESP_ERROR_CHECK(ledc_fade_start(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH, LEDC_FADE_NO_WAIT));
+    current_brightness_ = brightness;
+
+    // 原来的定时器方案每变化 1% 唤醒一次 CPU
+    backlight_fades_++;
+    backlight_steps_ += steps;
 }
 
 void LcdDisplay::SetBacklight(uint8_t brightness) {
@@ -265,12 +277,9 @@ void LcdDisplay::SetBacklight(uint8_t brightness) {
     }
 
     ESP_LOGI(TAG, "Setting LCD backlight: %d%%", brightness);
-    // 停止现有的定时器（如果正在运行）
-    esp_timer_stop(backlight_timer_);
-
     Display::SetBacklight(brightness);
-    // 启动定时器，每 5ms 更新一次
-    ESP_ERROR_CHECK(esp_timer_start_periodic(backlight_timer_, 5 * 1000));
+    backlight_level_ = kBacklightNormal;
+    ApplyBacklight(brightness);
 }
 
 bool LcdDisplay::Lock(int timeout_ms) {
@@ -315,11 +324,21 @@ void LcdDisplay::SetupUI() {
     lv_obj_set_style_text_font(emotion_label_, &font_awesome_30_4, 0);
     lv_label_set_text(emotion_label_, FONT_AWESOME_AI_CHIP);
 
-    chat_message_label_ = lv_label_create(content_);
-    lv_label_set_text(chat_message_label_, "");
-    lv_obj_set_width(chat_message_label_, LV_HOR_RES * 0.9); // 限制宽度为屏幕宽度的 90%
-    lv_label_set_long_mode(chat_message_label_, LV_LABEL_LONG_WRAP); // 设置为自动换行模式
-    lv_obj_set_style_text_align(chat_message_label_, LV_TEXT_ALIGN_CENTER, 0); // 设置文本居中对齐
+    // 表情精灵图分区是可选的，不存在时使用字体表情
+    emotion_sprites_.Load(LV_HOR_RES, LV_VER_RES / 2);
+
+    /* Chat view: 每条消息一个标签，新消息只需对新标签排版 */
+    chat_view_ = lv_obj_create(content_);
+    lv_obj_set_width(chat_view_, LV_HOR_RES * 0.9); // 限制宽度为屏幕宽度的 90%
+    lv_obj_set_flex_grow(chat_view_, 1);
+    lv_obj_set_flex_flow(chat_view_, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(chat_view_, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_scrollbar_mode(chat_view_, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_scroll_dir(chat_view_, LV_DIR_VER);
+    lv_obj_set_style_pad_all(chat_view_, 0, 0);
+    lv_obj_set_style_border_width(chat_view_, 0, 0);
+    lv_obj_set_style_bg_opa(chat_view_, LV_OPA_TRANSP, 0);
+    lv_obj_add_flag(chat_view_, LV_OBJ_FLAG_HIDDEN); // 没有消息时隐藏，表情保持居中
 
     /* Status bar */
     lv_obj_set_flex_flow(status_bar_, LV_FLEX_FLOW_ROW);
@@ -354,52 +373,108 @@ void LcdDisplay::SetupUI() {
 }
 
 void LcdDisplay::SetEmotion(const char* emotion) {
-    struct Emotion {
-        const char* icon;
-        const char* text;
+    // 按 EmotionId 顺序排列
+    static const char* const emojis[kEmotionCount] = {
+        "😶", "🙂", "😆", "😂", "😔", "😠", "😭", "😍", "😳", "😯", "😱",
+        "🤔", "😉", "😎", "😌", "🤤", "😘", "😏", "😴", "😜", "🙄",
     };
 
-    static const std::vector<Emotion> emotions = {
-        {"😶", "neutral"},
-        {"🙂", "happy"},
-        {"😆", "laughing"},
-        {"😂", "funny"},
-        {"😔", "sad"},
-        {"😠", "angry"},
-        {"😭", "crying"},
-        {"😍", "loving"},
-        {"😳", "embarrassed"},
-        {"😯", "surprised"},
-        {"😱", "shocked"},
-        {"🤔", "thinking"},
-        {"😉", "winking"},
-        {"😎", "cool"},
-        {"😌", "relaxed"},
-        {"🤤", "delicious"},
-        {"😘", "kissy"},
-        {"😏", "confident"},
-        {"😴", "sleepy"},
-        {"😜", "silly"},
-        {"🙄", "confused"}
-    };
-    
-    // 查找匹配的表情
-    std::string_view emotion_view(emotion);
-    auto it = std::find_if(emotions.begin(), emotions.end(),
-        [&emotion_view](const Emotion& e) { return e.text == emotion_view; });
+    // 未知的表情显示 neutral
+    auto id = GetEmotionId(emotion);
 
     DisplayLockGuard lock(this);
     if (emotion_label_ == nullptr) {
         return;
     }
 
-    // 如果找到匹配的表情就显示对应图标，否则显示默认的neutral表情
+    // 有精灵图的表情用图片播放，其余的使用字体表情
+    if (emotion_sprites_.frame_count(id) > 0) {
+        ShowEmotionSprite(id);
+        return;
+    }
+    HideEmotionSprite();
     lv_obj_set_style_text_font(emotion_label_, fonts_.emoji_font, 0);
-    if (it != emotions.end()) {
-        lv_label_set_text(emotion_label_, it->icon);
+    lv_label_set_text(emotion_label_, emojis[id]);
+}
+
+void LcdDisplay::ShowEmotionSprite(EmotionId id) {
+    if (emotion_image_ == nullptr) {
+        emotion_image_ = lv_image_create(content_);
+        lv_obj_move_to_index(emotion_image_, lv_obj_get_index(emotion_label_));
+        emotion_timer_ = lv_timer_create([](lv_timer_t* timer) {
+            auto display = static_cast<LcdDisplay*>(lv_timer_get_user_data(timer));
+            // 只替换图片源，LVGL 只重绘图片所在区域
+            display->emotion_frame_++;
+            lv_image_set_src(display->emotion_image_,
+                display->emotion_sprites_.GetFrame(display->emotion_id_, display->emotion_frame_));
+        }, 100, this);
+    }
+
+    emotion_id_ = id;
+    emotion_frame_ = 0;
+    lv_image_set_src(emotion_image_, emotion_sprites_.GetFrame(id, 0));
+    lv_obj_add_flag(emotion_label_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(emotion_image_, LV_OBJ_FLAG_HIDDEN);
+    if (emotion_sprites_.frame_count(id) > 1) {
+        lv_timer_set_period(emotion_timer_, emotion_sprites_.frame_interval_ms(id));
+        lv_timer_reset(emotion_timer_);
+        lv_timer_resume(emotion_timer_);
     } else {
-        lv_label_set_text(emotion_label_, "😶");
+        lv_timer_pause(emotion_timer_);
+    }
+}
+
+void LcdDisplay::HideEmotionSprite() {
+    if (emotion_image_ == nullptr) {
+        return;
+    }
+    lv_timer_pause(emotion_timer_);
+    lv_obj_add_flag(emotion_image_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(emotion_label_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void LcdDisplay::SetChatMessage(const char* role, const char* content) {
+    DisplayLockGuard lock(this);
+    if (chat_view_ == nullptr) {
+        Display::SetChatMessage(role, content);
+        return;
+    }
+
+    // 系统消息替换整个聊天区，对话消息追加到末尾
+    bool empty = content == nullptr || content[0] == '\0';
+    if (empty || strcmp(role, "system") == 0) {
+        lv_obj_clean(chat_view_);
+        if (empty) {
+            lv_obj_add_flag(chat_view_, LV_OBJ_FLAG_HIDDEN);
+            return;
+        }
+    }
+    if (lv_obj_get_child_count(chat_view_) >= LCD_CHAT_SCROLLBACK_MESSAGES) {
+        lv_obj_del(lv_obj_get_child(chat_view_, 0));
+    }
+
+    lv_obj_clear_flag(chat_view_, LV_OBJ_FLAG_HIDDEN);
+    auto label = lv_label_create(chat_view_);
+    lv_obj_set_width(label, lv_pct(100));
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP); // 设置为自动换行模式
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0); // 设置文本居中对齐
+    lv_label_set_text(label, content);
+    lv_obj_scroll_to_view(label, LV_ANIM_ON);
+}
+
+void LcdDisplay::LogRenderStats(const char* label) {
+    Display::LogRenderStats(label);
+    if (glyph_cache_ != nullptr) {
+        DisplayLockGuard lock(this);
+        glyph_cache_->LogStats();
+    }
+#if CONFIG_USE_DISPLAY_RENDER_STATS
+    if (backlight_fades_ > 0) {
+        ESP_LOGI(TAG, "Backlight: %lu hardware fades, %lu timer wakeups avoided", backlight_fades_, backlight_steps_);
+        backlight_fades_ = 0;
+        backlight_steps_ = 0;
     }
+#endif
 }
 
 void LcdDisplay::SetIcon(const char* icon) {
@@ -407,6 +482,7 @@ void LcdDisplay::SetIcon(const char* icon) {
     if (emotion_label_ == nullptr) {
         return;
     }
+    HideEmotionSprite();
     lv_obj_set_style_text_font(emotion_label_, &font_awesome_30_4, 0);
     lv_label_set_text(emotion_label_, icon);
 }
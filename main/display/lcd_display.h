@@ -2,6 +2,8 @@
 #define LCD_DISPLAY_H
 
 #include "display.h"
+#include "emotion_sprites.h"
+#include "glyph_cache.h"
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
@@ -13,6 +15,17 @@
 #include <font_emoji.h>
 
 #include <atomic>
+#include <memory>
+
+// LVGL 绘制缓冲区策略，由板子根据屏幕大小和可用内存选择
+struct DisplayBufferConfig {
+    int lines = 10;             // 每个缓冲区的行数，0 表示整帧缓冲
+    bool double_buffer = false; // 双缓冲时 LVGL 渲染下一块的同时 DMA 传输上一块
+    bool spiram = false;        // 缓冲区放在 PSRAM，经内部 RAM 的小块中转后发送；否则使用可 DMA 的内部 RAM
+};
+
+// 聊天区保留的消息条数，超出后删除最早的一条
+#define LCD_CHAT_SCROLLBACK_MESSAGES 8
 
 class LcdDisplay : public Display {
 protected:
@@ -26,12 +39,25 @@ protected:
     lv_obj_t* content_ = nullptr;
     lv_obj_t* container_ = nullptr;
     lv_obj_t* side_bar_ = nullptr;
+    lv_obj_t* chat_view_ = nullptr;
 
     DisplayFonts fonts_;
+    std::unique_ptr<GlyphCache> glyph_cache_;
 
-    esp_timer_handle_t backlight_timer_ = nullptr;
+    EmotionSprites emotion_sprites_;
+    lv_obj_t* emotion_image_ = nullptr;
+    lv_timer_t* emotion_timer_ = nullptr;
+    EmotionId emotion_id_ = kEmotionNeutral;
+    int emotion_frame_ = 0;
+    void ShowEmotionSprite(EmotionId id);
+    void HideEmotionSprite();
+
+    // 背光由 LEDC 硬件渐变，渐变过程中不需要 CPU 参与
     uint8_t current_brightness_ = 0;
+    uint32_t backlight_fades_ = 0;
+    uint32_t backlight_steps_ = 0;
     void InitializeBacklight(gpio_num_t backlight_pin);
+    virtual void ApplyBacklight(uint8_t brightness) override;
 
     virtual void SetupUI();
     virtual bool Lock(int timeout_ms = 0) override;
@@ -44,14 +70,21 @@ protected:
              DisplayFonts fonts)
         : panel_io_(panel_io), panel_(panel),
           backlight_pin_(backlight_pin), backlight_output_invert_(backlight_output_invert),
-          fonts_(fonts) {}
+          fonts_(fonts) {
+#if CONFIG_USE_GLYPH_CACHE
+        // 聊天文字和状态栏都继承屏幕的文字字体，换成带缓存的包装字体
+        glyph_cache_ = std::make_unique<GlyphCache>(fonts.text_font, CONFIG_GLYPH_CACHE_SIZE_KB * 1024);
+        fonts_.text_font = glyph_cache_->font();
+#endif
+    }
     
 public:
     ~LcdDisplay();
-    virtual void OnBacklightTimer();
     virtual void SetEmotion(const char* emotion) override;
     virtual void SetIcon(const char* icon) override;
+    virtual void SetChatMessage(const char* role, const char* content) override;
     virtual void SetBacklight(uint8_t brightness) override;
+    virtual void LogRenderStats(const char* label = "Render") override;
 };
 
 // RGB LCD显示器
@@ -81,7 +114,7 @@ public:
                   gpio_num_t backlight_pin, bool backlight_output_invert,
                   int width, int height, int offset_x, int offset_y,
                   bool mirror_x, bool mirror_y, bool swap_xy,
-                  DisplayFonts fonts);
+                  DisplayFonts fonts, DisplayBufferConfig buffer_config = {});
 };
 
 // QSPI LCD显示器
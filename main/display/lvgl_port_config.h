@@ -0,0 +1,14 @@
+#ifndef LVGL_PORT_CONFIG_H
+#define LVGL_PORT_CONFIG_H
+
+#include <esp_lvgl_port.h>
+
+// 所有屏幕共用的 LVGL 任务配置，运行核心和优先级由 Kconfig 决定
+inline lvgl_port_cfg_t GetLvglPortConfig() {
+    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    port_cfg.task_priority = CONFIG_LVGL_TASK_PRIORITY;
+    port_cfg.task_affinity = CONFIG_LVGL_TASK_CORE;
+    return port_cfg;
+}
+
+#endif // LVGL_PORT_CONFIG_H
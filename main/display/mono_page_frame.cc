@@ -0,0 +1,49 @@
+#include "mono_page_frame.h"
+
+#include <esp_heap_caps.h>
+
+MonoPageFrame::MonoPageFrame(int width, int height)
+    : width_(width), pages_(height / 8), dirty_(height / 8, DirtyRange{ static_cast<int16_t>(width), -1 }) {
+    frame_ = (uint8_t*)heap_caps_calloc(1, size(), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+MonoPageFrame::~MonoPageFrame() {
+    if (frame_ != nullptr) {
+        heap_caps_free(frame_);
+    }
+}
+
+void MonoPageFrame::Fold(int x1, int y1, int x2, int y2, const uint8_t* bits, uint32_t stride) {
+    for (int y = y1; y <= y2; y++) {
+        const uint8_t* row = bits + (y - y1) * stride;
+        uint8_t* page = frame_ + (y / 8) * width_;
+        uint8_t mask = 1 << (y % 8);
+        auto& dirty = dirty_[y / 8];
+        for (int x = x1; x <= x2; x++) {
+            int i = x - x1;
+            bool on = (row[i >> 3] & (0x80 >> (i & 7))) == 0;
+            uint8_t value = on ? (page[x] | mask) : (page[x] & ~mask);
+            if (value == page[x]) {
+                continue;
+            }
+            page[x] = value;
+            if (x < dirty.x1) {
+                dirty.x1 = x;
+            }
+            if (x > dirty.x2) {
+                dirty.x2 = x;
+            }
+        }
+    }
+}
+
+bool MonoPageFrame::TakeDirtyRange(int index, int& x1, int& x2) {
+    auto& dirty = dirty_[index];
+    if (dirty.x2 < dirty.x1) {
+        return false;
+    }
+    x1 = dirty.x1;
+    x2 = dirty.x2;
+    dirty = { static_cast<int16_t>(width_), -1 };
+    return true;
+}
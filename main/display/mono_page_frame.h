@@ -0,0 +1,41 @@
+#ifndef MONO_PAGE_FRAME_H
+#define MONO_PAGE_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SSD1306 等单色屏的页格式帧缓冲（每字节纵向 8 行），保存屏幕当前内容，
+// 合并 LVGL 的 1bpp 渲染结果时记录每页内容变化的列范围，只发送变化的部分
+class MonoPageFrame {
+public:
+    // 初始内容全黑，height 需为 8 的倍数
+    MonoPageFrame(int width, int height);
+    ~MonoPageFrame();
+    MonoPageFrame(const MonoPageFrame&) = delete;
+    MonoPageFrame& operator=(const MonoPageFrame&) = delete;
+
+    // 内存分配失败时返回 false
+    inline bool valid() const { return frame_ != nullptr; }
+    inline const uint8_t* data() const { return frame_; }
+    inline size_t size() const { return width_ * pages_; }
+    inline int pages() const { return pages_; }
+    inline const uint8_t* page(int index) const { return frame_ + index * width_; }
+
+    // bits 为 LVGL I1 格式的区域（不含调色板），每行 stride 字节，高位在左，位为 0 表示点亮
+    void Fold(int x1, int y1, int x2, int y2, const uint8_t* bits, uint32_t stride);
+    // 取出第 index 页变化的列范围 [x1, x2] 并清除，没有变化时返回 false
+    bool TakeDirtyRange(int index, int& x1, int& x2);
+
+private:
+    struct DirtyRange {
+        int16_t x1;
+        int16_t x2;
+    };
+    int width_;
+    int pages_;
+    uint8_t* frame_ = nullptr;
+    std::vector<DirtyRange> dirty_;
+};
+
+#endif // MONO_PAGE_FRAME_H
@@ -0,0 +1,66 @@
+#include "render_benchmark.h"
+#include "display.h"
+
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define TAG "RenderBenchmark"
+
+#define RENDER_BENCHMARK_ITERATIONS 20
+#define RENDER_BENCHMARK_INTERVAL_MS 100
+// 每一步结束后等待最后一次合并更新和动画刷新完成再统计
+#define RENDER_BENCHMARK_SETTLE_MS 500
+
+namespace {
+
+struct BenchmarkStep {
+    const char* name;
+    void (*update)(Display* display, int iteration);
+};
+
+const char* const kStatuses[] = { "待命", "聆听中...", "说话中...", "12:34" };
+const char* const kEmotions[] = { "neutral", "happy", "sad", "thinking", "surprised", "loving" };
+const char* const kChatMessages[] = {
+    "你好",
+    "今天天气怎么样？",
+    "今天晴转多云，最高气温二十六度，最低气温十八度，适合出门散步，记得带上一件薄外套。",
+};
+
+const BenchmarkStep kSteps[] = {
+    { "status", [](Display* display, int i) {
+        display->PostStatus(kStatuses[i % 4]);
+    } },
+    { "emotion", [](Display* display, int i) {
+        display->PostEmotion(kEmotions[i % 6]);
+    } },
+    { "chat", [](Display* display, int i) {
+        display->PostChatMessage(i % 2 ? "assistant" : "user", kChatMessages[i % 3]);
+    } },
+    // 模拟一次对话中同一帧内的多种更新
+    { "mixed", [](Display* display, int i) {
+        display->PostStatus(kStatuses[i % 4]);
+        display->PostEmotion(kEmotions[i % 6]);
+        display->PostChatMessage("assistant", kChatMessages[i % 3]);
+    } },
+    // 没有更新时不应产生任何刷新
+    { "idle", [](Display* display, int i) {} },
+};
+
+} // namespace
+
+void RunRenderBenchmark(Display* display) {
+    ESP_LOGI(TAG, "Display %dx%d, %d iterations per step", display->width(), display->height(),
+        RENDER_BENCHMARK_ITERATIONS);
+    vTaskDelay(pdMS_TO_TICKS(RENDER_BENCHMARK_SETTLE_MS));
+    display->LogRenderStats("startup");
+
+    for (auto& step : kSteps) {
+        for (int i = 0; i < RENDER_BENCHMARK_ITERATIONS; i++) {
+            step.update(display, i);
+            vTaskDelay(pdMS_TO_TICKS(RENDER_BENCHMARK_INTERVAL_MS));
+        }
+        vTaskDelay(pdMS_TO_TICKS(RENDER_BENCHMARK_SETTLE_MS));
+        display->LogRenderStats(step.name);
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+class Display;
+
+// 按固定脚本依次回放状态、表情和聊天消息更新，每一步结束后打印该步的渲染统计，
+// 用于在真机上比较不同屏幕和界面改动的渲染开销，需要启用 CONFIG_USE_DISPLAY_RENDER_STATS
+void RunRenderBenchmark(Display* display);
+
+#endif // RENDER_BENCHMARK_H
@@ -6,6 +6,8 @@
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_vendor.h>
 #include <esp_lvgl_port.h>
+#include "lvgl_port_config.h"
+#include <esp_heap_caps.h>
 #include "assets/lang_config.h"
 
 #define TAG "Ssd1306Display"
@@ -19,7 +21,7 @@ Ssd1306Display::Ssd1306Display(void* i2c_master_handle, int width, int height, b
     height_ = height;
 
     ESP_LOGI(TAG, "Initialize LVGL");
-    lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_cfg_t port_cfg = GetLvglPortConfig();
     lvgl_port_init(&port_cfg);
 
     // SSD1306 config
@@ -65,35 +67,34 @@ Ssd1306Display::Ssd1306Display(void* i2c_master_handle, int width, int height, b
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_, true));
 
     ESP_LOGI(TAG, "Adding LCD screen");
-    const lvgl_port_display_cfg_t display_cfg = {
-        .io_handle = panel_io_,
-        .panel_handle = panel_,
-        .control_handle = nullptr,
-        .buffer_size = static_cast<uint32_t>(width_ * height_),
-        .double_buffer = false,
-        .trans_size = 0,
-        .hres = static_cast<uint32_t>(width_),
-        .vres = static_cast<uint32_t>(height_),
-        .monochrome = true,
-        .rotation = {
-            .swap_xy = false,
-            .mirror_x = mirror_x,
-            .mirror_y = mirror_y,
-        },
-        .flags = {
-            .buff_dma = 1,
-            .buff_spiram = 0,
-            .sw_rotate = 0,
-            .full_refresh = 0,
-            .direct_mode = 0,
-        },
-    };
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_, mirror_x, mirror_y));
+
+    // 屏幕 RAM 上电后内容不确定，先整屏清空，使 frame_ 与屏幕一致
+    frame_ = std::make_unique<MonoPageFrame>(width_, height_);
+    // I1 格式的绘制缓冲区开头是 2 色调色板，一次渲染整屏
+    size_t draw_buffer_size = frame_->size() + LV_COLOR_INDEXED_PALETTE_SIZE(LV_COLOR_FORMAT_I1) * sizeof(lv_color32_t);
+    draw_buffer_ = (uint8_t*)heap_caps_malloc(draw_buffer_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!frame_->valid() || draw_buffer_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate frame buffer");
+        return;
+    }
+    ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(panel_, 0, 0, width_, height_, frame_->data()));
 
-    display_ = lvgl_port_add_disp(&display_cfg);
+    lvgl_port_lock(0);
+    display_ = lv_display_create(width_, height_);
     if (display_ == nullptr) {
+        lvgl_port_unlock();
         ESP_LOGE(TAG, "Failed to add display");
         return;
     }
+    lv_display_set_color_format(display_, LV_COLOR_FORMAT_I1);
+    lv_display_set_buffers(display_, draw_buffer_, nullptr, draw_buffer_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_user_data(display_, this);
+    lv_display_set_flush_cb(display_, FlushCallback);
+    lvgl_port_unlock();
+
+    InitializeRenderStats();
+    InitializeIdleSuspend();
 
     if (height_ == 64) {
         SetupUI_128x64();
@@ -116,6 +117,12 @@ Ssd1306Display::~Ssd1306Display() {
         lv_obj_del(container_);
     }
 
+    if (display_ != nullptr) {
+        lv_display_delete(display_);
+    }
+    if (draw_buffer_ != nullptr) {
+        heap_caps_free(draw_buffer_);
+    }
     if (panel_ != nullptr) {
         esp_lcd_panel_del(panel_);
     }
@@ -125,6 +132,58 @@ Ssd1306Display::~Ssd1306Display() {
     lvgl_port_deinit();
 }
 
+void Ssd1306Display::FlushCallback(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    auto display = static_cast<Ssd1306Display*>(lv_display_get_user_data(disp));
+    display->Flush(area, px_map);
+    lv_display_flush_ready(disp);
+}
+
+void Ssd1306Display::Flush(const lv_area_t* area, const uint8_t* px_map) {
+    // 跳过调色板，LVGL 中深色像素（位为 0）对应 OLED 点亮，与 esp_lvgl_port 的单色转换一致
+    px_map += LV_COLOR_INDEXED_PALETTE_SIZE(LV_COLOR_FORMAT_I1) * sizeof(lv_color32_t);
+    uint32_t stride = lv_draw_buf_width_to_stride(lv_area_get_width(area), LV_COLOR_FORMAT_I1);
+    frame_->Fold(area->x1, area->y1, area->x2, area->y2, px_map, stride);
+
+    // 一帧可能分多次 flush，全部合并到 frame_ 后再统一发送
+    if (lv_display_flush_is_last(display_)) {
+        SendDirtyPages();
+    }
+}
+
+void Ssd1306Display::SendDirtyPages() {
+    bool sent = false;
+    int x1, x2;
+    for (int i = 0; i < frame_->pages(); i++) {
+        if (!frame_->TakeDirtyRange(i, x1, x2)) {
+            continue;
+        }
+        // 列地址和页地址窗口只覆盖变化的范围，每页一次 I2C 传输
+        esp_lcd_panel_draw_bitmap(panel_, x1, i * 8, x2 + 1, i * 8 + 8, frame_->page(i) + x1);
+        pages_sent_++;
+        bytes_sent_ += x2 - x1 + 1;
+        sent = true;
+    }
+    if (sent) {
+        frames_sent_++;
+    }
+}
+
+void Ssd1306Display::LogRenderStats(const char* label) {
+    Display::LogRenderStats(label);
+#if CONFIG_USE_DISPLAY_RENDER_STATS
+    uint32_t frames, pages, bytes;
+    {
+        DisplayLockGuard lock(this);
+        frames = frames_sent_;
+        pages = pages_sent_;
+        bytes = bytes_sent_;
+        frames_sent_ = pages_sent_ = bytes_sent_ = 0;
+    }
+    ESP_LOGI(TAG, "I2C: %lu frames, %lu pages, %lu bytes (full frame %d bytes)",
+        frames, pages, bytes, width_ * height_ / 8);
+#endif
+}
+
 bool Ssd1306Display::Lock(int timeout_ms) {
     return lvgl_port_lock(timeout_ms);
 }
@@ -2,10 +2,13 @@
 #define SSD1306_DISPLAY_H
 
 #include "display.h"
+#include "mono_page_frame.h"
 
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
 
+#include <memory>
+
 class Ssd1306Display : public Display {
 private:
     esp_lcd_panel_io_handle_t panel_io_ = nullptr;
@@ -21,6 +24,18 @@ private:
     const lv_font_t* text_font_ = nullptr;
     const lv_font_t* icon_font_ = nullptr;
 
+    // LVGL 直接以 1bpp 渲染，frame_ 按 SSD1306 页格式保存屏幕当前内容，
+    // 刷新时只把内容有变化的页和列范围通过 I2C 发送出去
+    uint8_t* draw_buffer_ = nullptr;
+    std::unique_ptr<MonoPageFrame> frame_;
+    uint32_t pages_sent_ = 0;
+    uint32_t bytes_sent_ = 0;
+    uint32_t frames_sent_ = 0;
+
+    static void FlushCallback(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map);
+    void Flush(const lv_area_t* area, const uint8_t* px_map);
+    void SendDirtyPages();
+
     virtual bool Lock(int timeout_ms = 0) override;
     virtual void Unlock() override;
 
@@ -33,6 +48,7 @@ public:
     ~Ssd1306Display();
 
     virtual void SetChatMessage(const char* role, const char* content) override;
+    virtual void LogRenderStats(const char* label = "Render") override;
 };
 
 #endif // SSD1306_DISPLAY_H
@@ -0,0 +1,19 @@
+#ifndef FNV_HASH_H
+#define FNV_HASH_H
+
+#include <cstdint>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+// 32 位 FNV-1a 哈希，字面量的哈希在编译期即可算出，可以直接用作 case 标签
+// hash 传入已有的哈希值时在其后继续累加
+constexpr uint32_t FnvHash(const char* str, uint32_t hash = FNV_OFFSET_BASIS) {
+    return *str == '\0' ? hash : FnvHash(str + 1, (hash ^ uint8_t(*str)) * FNV_PRIME);
+}
+
+constexpr uint32_t FnvHash(char c, uint32_t hash) {
+    return (hash ^ uint8_t(c)) * FNV_PRIME;
+}
+
+#endif // FNV_HASH_H
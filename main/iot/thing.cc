@@ -26,22 +26,22 @@ Thing* CreateThing(const std::string& type) {
     return creator->second();
 }
 
-std::string Thing::GetDescriptorJson() {
-    std::string json_str = "{";
-    json_str += "\"name\":\"" + name_ + "\",";
-    json_str += "\"description\":\"" + description_ + "\",";
-    json_str += "\"properties\":" + properties_.GetDescriptorJson() + ",";
-    json_str += "\"methods\":" + methods_.GetDescriptorJson();
-    json_str += "}";
-    return json_str;
+void Thing::GetDescriptorJson(JsonWriter& writer) {
+    writer.BeginObject()
+        .AddString("name", name_)
+        .AddString("description", description_);
+    writer.Key("properties");
+    properties_.GetDescriptorJson(writer);
+    writer.Key("methods");
+    methods_.GetDescriptorJson(writer);
+    writer.EndObject();
 }
 
-std::string Thing::GetStateJson() {
-    std::string json_str = "{";
-    json_str += "\"name\":\"" + name_ + "\",";
-    json_str += "\"state\":" + properties_.GetStateJson();
-    json_str += "}";
-    return json_str;
+void Thing::GetStateJson(JsonWriter& writer) {
+    writer.BeginObject().AddString("name", name_);
+    writer.Key("state");
+    properties_.GetStateJson(writer);
+    writer.EndObject();
 }
 
 void Thing::Invoke(const cJSON* command) {
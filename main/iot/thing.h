@@ -8,6 +8,8 @@
 #include <stdexcept>
 #include <cJSON.h>
 
+#include "json_writer.h"
+
 namespace iot {
 
 enum ValueType {
@@ -41,29 +43,28 @@ public:
     int number() const { return number_getter_(); }
     std::string string() const { return string_getter_(); }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
-        json_str += "\"description\":\"" + description_ + "\",";
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject().AddString("description", description_);
         if (type_ == kValueTypeBoolean) {
-            json_str += "\"type\":\"boolean\"";
+            writer.AddString("type", "boolean");
         } else if (type_ == kValueTypeNumber) {
-            json_str += "\"type\":\"number\"";
+            writer.AddString("type", "number");
         } else if (type_ == kValueTypeString) {
-            json_str += "\"type\":\"string\"";
+            writer.AddString("type", "string");
         }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 
-    std::string GetStateJson() {
+    void GetStateJson(JsonWriter& writer) {
         if (type_ == kValueTypeBoolean) {
-            return boolean_getter_() ? "true" : "false";
+            writer.Bool(boolean_getter_());
         } else if (type_ == kValueTypeNumber) {
-            return std::to_string(number_getter_());
+            writer.Int(number_getter_());
         } else if (type_ == kValueTypeString) {
-            return "\"" + string_getter_() + "\"";
+            writer.String(string_getter_());
+        } else {
+            writer.Null();
         }
-        return "null";
     }
 };
 
@@ -94,28 +95,22 @@ public:
         throw std::runtime_error("Property not found: " + name);
     }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject();
         for (auto& property : properties_) {
-            json_str += "\"" + property.name() + "\":" + property.GetDescriptorJson() + ",";
-        }
-        if (json_str.back() == ',') {
-            json_str.pop_back();
+            writer.Key(property.name());
+            property.GetDescriptorJson(writer);
         }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 
-    std::string GetStateJson() {
-        std::string json_str = "{";
+    void GetStateJson(JsonWriter& writer) {
+        writer.BeginObject();
         for (auto& property : properties_) {
-            json_str += "\"" + property.name() + "\":" + property.GetStateJson() + ",";
-        }
-        if (json_str.back() == ',') {
-            json_str.pop_back();
+            writer.Key(property.name());
+            property.GetStateJson(writer);
         }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 };
 
@@ -146,18 +141,16 @@ public:
     void set_number(int value) { number_ = value; }
     void set_string(const std::string& value) { string_ = value; }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
-        json_str += "\"description\":\"" + description_ + "\",";
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject().AddString("description", description_);
         if (type_ == kValueTypeBoolean) {
-            json_str += "\"type\":\"boolean\"";
+            writer.AddString("type", "boolean");
         } else if (type_ == kValueTypeNumber) {
-            json_str += "\"type\":\"number\"";
+            writer.AddString("type", "number");
         } else if (type_ == kValueTypeString) {
-            json_str += "\"type\":\"string\"";
+            writer.AddString("type", "string");
         }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 };
 
@@ -185,16 +178,13 @@ public:
     auto begin() { return parameters_.begin(); }
     auto end() { return parameters_.end(); }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject();
         for (auto& parameter : parameters_) {
-            json_str += "\"" + parameter.name() + "\":" + parameter.GetDescriptorJson() + ",";
+            writer.Key(parameter.name());
+            parameter.GetDescriptorJson(writer);
         }
-        if (json_str.back() == ',') {
-            json_str.pop_back();
-        }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 };
 
@@ -213,12 +203,11 @@ public:
     const std::string& description() const { return description_; }
     ParameterList& parameters() { return parameters_; }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
-        json_str += "\"description\":\"" + description_ + "\",";
-        json_str += "\"parameters\":" + parameters_.GetDescriptorJson();
-        json_str += "}";
-        return json_str;
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject().AddString("description", description_);
+        writer.Key("parameters");
+        parameters_.GetDescriptorJson(writer);
+        writer.EndObject();
     }
 
     void Invoke() {
@@ -247,16 +236,13 @@ public:
         throw std::runtime_error("Method not found: " + name);
     }
 
-    std::string GetDescriptorJson() {
-        std::string json_str = "{";
+    void GetDescriptorJson(JsonWriter& writer) {
+        writer.BeginObject();
         for (auto& method : methods_) {
-            json_str += "\"" + method.name() + "\":" + method.GetDescriptorJson() + ",";
-        }
-        if (json_str.back() == ',') {
-            json_str.pop_back();
+            writer.Key(method.name());
+            method.GetDescriptorJson(writer);
         }
-        json_str += "}";
-        return json_str;
+        writer.EndObject();
     }
 };
 
@@ -266,8 +252,8 @@ public:
         name_(name), description_(description) {}
     virtual ~Thing() = default;
 
-    virtual std::string GetDescriptorJson();
-    virtual std::string GetStateJson();
+    virtual void GetDescriptorJson(JsonWriter& writer);
+    virtual void GetStateJson(JsonWriter& writer);
     virtual void Invoke(const cJSON* command);
 
     const std::string& name() const { return name_; }
@@ -11,27 +11,23 @@ void ThingManager::AddThing(Thing* thing) {
 }
 
 std::string ThingManager::GetDescriptorsJson() {
-    std::string json_str = "[";
-    for (auto& thing : things_) {
-        json_str += thing->GetDescriptorJson() + ",";
-    }
-    if (json_str.back() == ',') {
-        json_str.pop_back();
-    }
-    json_str += "]";
-    return json_str;
+    return HeapJsonWriter::Write(2048, [this](JsonWriter& writer) {
+        writer.BeginArray();
+        for (auto& thing : things_) {
+            thing->GetDescriptorJson(writer);
+        }
+        writer.EndArray();
+    });
 }
 
 std::string ThingManager::GetStatesJson() {
-    std::string json_str = "[";
-    for (auto& thing : things_) {
-        json_str += thing->GetStateJson() + ",";
-    }
-    if (json_str.back() == ',') {
-        json_str.pop_back();
-    }
-    json_str += "]";
-    return json_str;
+    return HeapJsonWriter::Write(512, [this](JsonWriter& writer) {
+        writer.BeginArray();
+        for (auto& thing : things_) {
+            thing->GetStateJson(writer);
+        }
+        writer.EndArray();
+    });
 }
 
 void ThingManager::Invoke(const cJSON* command) {
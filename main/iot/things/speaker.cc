@@ -18,6 +18,11 @@ public:
             return codec->output_volume();
         });
 
+        properties_.AddBooleanProperty("mute", "扬声器是否静音", [this]() -> bool {
+            auto codec = Board::GetInstance().GetAudioCodec();
+            return codec->output_muted();
+        });
+
         // 定义设备可以被远程执行的指令
         methods_.AddMethod("SetVolume", "设置音量", ParameterList({
             Parameter("volume", "0到100之间的整数", kValueTypeNumber, true)
@@ -25,6 +30,14 @@ public:
             auto codec = Board::GetInstance().GetAudioCodec();
             codec->SetOutputVolume(static_cast<uint8_t>(parameters["volume"].number()));
         });
+
+        // 静音不改变保存的音量，取消静音后恢复原来的音量
+        methods_.AddMethod("SetMute", "设置静音", ParameterList({
+            Parameter("mute", "true 表示静音，false 表示取消静音", kValueTypeBoolean, true)
+        }), [this](const ParameterList& parameters) {
+            auto codec = Board::GetInstance().GetAudioCodec();
+            codec->SetOutputMute(parameters["mute"].boolean());
+        });
     }
 };
 
@@ -0,0 +1,267 @@
+#include "json_reader.h"
+
+#include <cstring>
+#include <cstdint>
+
+// 跳过嵌套值时允许的最大深度，防止恶意消息耗尽栈空间
+#define JSON_READER_MAX_DEPTH 16
+
+namespace {
+
+struct Cursor {
+    char* p;
+    char* end;
+};
+
+void SkipWhitespace(Cursor& c) {
+    while (c.p < c.end && (*c.p == ' ' || *c.p == '\t' || *c.p == '\n' || *c.p == '\r')) {
+        c.p++;
+    }
+}
+
+bool ParseHex4(const char* p, uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        char h = p[i];
+        value <<= 4;
+        if (h >= '0' && h <= '9') {
+            value |= h - '0';
+        } else if (h >= 'a' && h <= 'f') {
+            value |= h - 'a' + 10;
+        } else if (h >= 'A' && h <= 'F') {
+            value |= h - 'A' + 10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 转义序列总是长于对应的 UTF-8 编码，所以写指针永远不会超过读指针
+char* WriteUtf8(char* out, uint32_t code) {
+    if (code < 0x80) {
+        *out++ = code;
+    } else if (code < 0x800) {
+        *out++ = 0xC0 | (code >> 6);
+        *out++ = 0x80 | (code & 0x3F);
+    } else if (code < 0x10000) {
+        *out++ = 0xE0 | (code >> 12);
+        *out++ = 0x80 | ((code >> 6) & 0x3F);
+        *out++ = 0x80 | (code & 0x3F);
+    } else {
+        *out++ = 0xF0 | (code >> 18);
+        *out++ = 0x80 | ((code >> 12) & 0x3F);
+        *out++ = 0x80 | ((code >> 6) & 0x3F);
+        *out++ = 0x80 | (code & 0x3F);
+    }
+    return out;
+}
+
+// 解析以引号开头的字符串，原地反转义后返回起始指针
+bool ParseString(Cursor& c, char*& value) {
+    if (c.p >= c.end || *c.p != '"') {
+        return false;
+    }
+    c.p++;
+    value = c.p;
+    char* out = c.p;
+    while (c.p < c.end) {
+        char ch = *c.p++;
+        if (ch == '"') {
+            *out = '\0';
+            return true;
+        }
+        if ((unsigned char)ch < 0x20) {
+            return false;
+        }
+        if (ch != '\\') {
+            *out++ = ch;
+            continue;
+        }
+        if (c.p >= c.end) {
+            return false;
+        }
+        ch = *c.p++;
+        switch (ch) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (c.end - c.p < 4 || !ParseHex4(c.p, code)) {
+                    return false;
+                }
+                c.p += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // UTF-16 代理对
+                    uint32_t low;
+                    if (c.end - c.p < 6 || c.p[0] != '\\' || c.p[1] != 'u' || !ParseHex4(c.p + 2, low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    c.p += 6;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return false;
+                }
+                out = WriteUtf8(out, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+bool SkipLiteral(Cursor& c, const char* literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(c.end - c.p) < length || memcmp(c.p, literal, length) != 0) {
+        return false;
+    }
+    c.p += length;
+    return true;
+}
+
+bool SkipNumber(Cursor& c) {
+    char* start = c.p;
+    if (c.p < c.end && *c.p == '-') {
+        c.p++;
+    }
+    bool digits = false;
+    while (c.p < c.end && ((*c.p >= '0' && *c.p <= '9') || *c.p == '.' || *c.p == 'e' || *c.p == 'E' ||
+        *c.p == '+' || *c.p == '-')) {
+        digits = digits || (*c.p >= '0' && *c.p <= '9');
+        c.p++;
+    }
+    return digits && c.p > start;
+}
+
+bool SkipValue(Cursor& c, int depth);
+
+bool SkipContainer(Cursor& c, int depth, char close) {
+    if (depth >= JSON_READER_MAX_DEPTH) {
+        return false;
+    }
+    c.p++;
+    SkipWhitespace(c);
+    if (c.p < c.end && *c.p == close) {
+        c.p++;
+        return true;
+    }
+    while (c.p < c.end) {
+        if (close == '}') {
+            char* key;
+            if (!ParseString(c, key)) {
+                return false;
+            }
+            SkipWhitespace(c);
+            if (c.p >= c.end || *c.p++ != ':') {
+                return false;
+            }
+        }
+        if (!SkipValue(c, depth + 1)) {
+            return false;
+        }
+        SkipWhitespace(c);
+        if (c.p >= c.end) {
+            return false;
+        }
+        char ch = *c.p++;
+        if (ch == close) {
+            return true;
+        }
+        if (ch != ',') {
+            return false;
+        }
+        SkipWhitespace(c);
+    }
+    return false;
+}
+
+bool SkipValue(Cursor& c, int depth) {
+    SkipWhitespace(c);
+    if (c.p >= c.end) {
+        return false;
+    }
+    switch (*c.p) {
+        case '{': return SkipContainer(c, depth, '}');
+        case '[': return SkipContainer(c, depth, ']');
+        case '"': {
+            char* value;
+            return ParseString(c, value);
+        }
+        case 't': return SkipLiteral(c, "true");
+        case 'f': return SkipLiteral(c, "false");
+        case 'n': return SkipLiteral(c, "null");
+        default: return SkipNumber(c);
+    }
+}
+
+} // namespace
+
+bool JsonReader::ParseStringFields(char* json, size_t length,
+    const char* const names[], const char* values[], size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = nullptr;
+    }
+
+    Cursor c = { json, json + length };
+    SkipWhitespace(c);
+    if (c.p >= c.end || *c.p != '{') {
+        return false;
+    }
+    c.p++;
+    SkipWhitespace(c);
+    if (c.p < c.end && *c.p == '}') {
+        return true;
+    }
+
+    while (c.p < c.end) {
+        char* key;
+        if (!ParseString(c, key)) {
+            return false;
+        }
+        SkipWhitespace(c);
+        if (c.p >= c.end || *c.p++ != ':') {
+            return false;
+        }
+        SkipWhitespace(c);
+
+        size_t field = count;
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(key, names[i]) == 0) {
+                field = i;
+                break;
+            }
+        }
+        if (field < count && c.p < c.end && *c.p == '"') {
+            char* value;
+            if (!ParseString(c, value)) {
+                return false;
+            }
+            values[field] = value;
+        } else if (!SkipValue(c, 1)) {
+            return false;
+        }
+
+        SkipWhitespace(c);
+        if (c.p >= c.end) {
+            return false;
+        }
+        char ch = *c.p++;
+        if (ch == '}') {
+            return true;
+        }
+        if (ch != ',') {
+            return false;
+        }
+        SkipWhitespace(c);
+    }
+    return false;
+}
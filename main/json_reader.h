@@ -0,0 +1,17 @@
+#ifndef _JSON_READER_H_
+#define _JSON_READER_H_
+
+#include <cstddef>
+
+// 零分配的 JSON 读取器，只提取顶层对象中指定名称的字符串字段
+// 在调用者的缓冲区内原地解析：字符串原地反转义并以 '\0' 结尾，返回的指针指向缓冲区内部
+// 数字、布尔、嵌套对象和数组会被校验并跳过，需要这些字段时请使用 cJSON
+class JsonReader {
+public:
+    // names 与 values 一一对应，未出现或不是字符串的字段对应的 value 为 nullptr
+    // 语法错误或嵌套过深时返回 false，此时 values 的内容无效
+    static bool ParseStringFields(char* json, size_t length,
+        const char* const names[], const char* values[], size_t count);
+};
+
+#endif // _JSON_READER_H_
@@ -0,0 +1,196 @@
+#include "json_writer.h"
+
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "JsonWriter"
+
+// 单条消息的上限，防止写入函数出错时无限加倍
+#define JSON_WRITER_MAX_CAPACITY (64 * 1024)
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {
+    if (capacity_ == 0) {
+        overflow_ = true;
+        return;
+    }
+    buffer_[0] = '\0';
+}
+
+void JsonWriter::Put(char c) {
+    // 保留一个字节给结尾的 '\0'
+    if (overflow_ || size_ + 1 >= capacity_) {
+        overflow_ = true;
+        return;
+    }
+    buffer_[size_++] = c;
+    buffer_[size_] = '\0';
+}
+
+void JsonWriter::Append(const char* data, size_t length) {
+    if (overflow_ || size_ + length >= capacity_) {
+        overflow_ = true;
+        return;
+    }
+    memcpy(buffer_ + size_, data, length);
+    size_ += length;
+    buffer_[size_] = '\0';
+}
+
+void JsonWriter::AppendEscaped(const char* value, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    Put('"');
+    const char* run = value;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = value[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        // 先整段写入不需要转义的部分，UTF-8 多字节字符原样输出
+        Append(run, value + i - run);
+        run = value + i + 1;
+        switch (c) {
+            case '"': Append("\\\"", 2); break;
+            case '\\': Append("\\\\", 2); break;
+            case '\b': Append("\\b", 2); break;
+            case '\f': Append("\\f", 2); break;
+            case '\n': Append("\\n", 2); break;
+            case '\r': Append("\\r", 2); break;
+            case '\t': Append("\\t", 2); break;
+            default: {
+                char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+                Append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+    Append(run, value + length - run);
+    Put('"');
+}
+
+void JsonWriter::Separator() {
+    if (need_comma_) {
+        Put(',');
+    }
+    need_comma_ = true;
+}
+
+JsonWriter& JsonWriter::BeginObject() {
+    Separator();
+    Put('{');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    Put('}');
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    Separator();
+    Put('[');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    Put(']');
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(const char* key) {
+    Separator();
+    AppendEscaped(key, strlen(key));
+    Put(':');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(const std::string& key) {
+    Separator();
+    AppendEscaped(key.data(), key.size());
+    Put(':');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(const char* value) {
+    return String(value, strlen(value));
+}
+
+JsonWriter& JsonWriter::String(const char* value, size_t length) {
+    Separator();
+    AppendEscaped(value, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::String(const std::string& value) {
+    return String(value.data(), value.size());
+}
+
+JsonWriter& JsonWriter::Int(int64_t value) {
+    Separator();
+    char digits[20];
+    int count = 0;
+    uint64_t magnitude = value < 0 ? 0 - uint64_t(value) : uint64_t(value);
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        Put('-');
+    }
+    while (count > 0) {
+        Put(digits[--count]);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+    Separator();
+    if (value) {
+        Append("true", 4);
+    } else {
+        Append("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+    Separator();
+    Append("null", 4);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Raw(const char* json, size_t length) {
+    Separator();
+    Append(json, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::Raw(const std::string& json) {
+    return Raw(json.data(), json.size());
+}
+
+HeapJsonWriter::HeapJsonWriter(size_t capacity)
+    : HeapJsonWriter(std::unique_ptr<char[]>(new char[capacity]), capacity) {
+}
+
+HeapJsonWriter::HeapJsonWriter(std::unique_ptr<char[]> storage, size_t capacity)
+    : JsonWriter(storage.get(), capacity), storage_(std::move(storage)) {
+}
+
+std::string HeapJsonWriter::Write(size_t initial_capacity, const std::function<void(JsonWriter& writer)>& write) {
+    for (size_t capacity = initial_capacity; capacity <= JSON_WRITER_MAX_CAPACITY; capacity *= 2) {
+        HeapJsonWriter writer(capacity);
+        write(writer);
+        if (writer.ok()) {
+            return writer.ToString();
+        }
+        ESP_LOGW(TAG, "JSON exceeds %u bytes, retrying", (unsigned)capacity);
+    }
+    ESP_LOGE(TAG, "JSON exceeds %u bytes", (unsigned)JSON_WRITER_MAX_CAPACITY);
+    return std::string();
+}
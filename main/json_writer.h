@@ -0,0 +1,82 @@
+#ifndef _JSON_WRITER_H_
+#define _JSON_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <functional>
+
+// 流式 JSON 生成器，直接写入调用者提供的固定缓冲区，不产生中间字符串
+// 逗号由写入器自动插入；缓冲区不足时停止写入并通过 ok() 返回 false
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t capacity);
+
+    JsonWriter& BeginObject();
+    JsonWriter& EndObject();
+    JsonWriter& BeginArray();
+    JsonWriter& EndArray();
+
+    JsonWriter& Key(const char* key);
+    JsonWriter& Key(const std::string& key);
+    JsonWriter& String(const char* value);
+    JsonWriter& String(const char* value, size_t length);
+    JsonWriter& String(const std::string& value);
+    JsonWriter& Int(int64_t value);
+    JsonWriter& Bool(bool value);
+    JsonWriter& Null();
+    // 直接写入已经序列化好的 JSON 片段
+    JsonWriter& Raw(const char* json, size_t length);
+    JsonWriter& Raw(const std::string& json);
+
+    inline JsonWriter& AddString(const char* key, const char* value) { return Key(key).String(value); }
+    inline JsonWriter& AddString(const char* key, const std::string& value) { return Key(key).String(value); }
+    inline JsonWriter& AddInt(const char* key, int64_t value) { return Key(key).Int(value); }
+    inline JsonWriter& AddBool(const char* key, bool value) { return Key(key).Bool(value); }
+    inline JsonWriter& AddRaw(const char* key, const std::string& json) { return Key(key).Raw(json); }
+
+    inline bool ok() const { return !overflow_; }
+    inline const char* c_str() const { return buffer_; }
+    inline size_t size() const { return size_; }
+    inline size_t capacity() const { return capacity_; }
+    inline std::string ToString() const { return std::string(buffer_, size_); }
+
+private:
+    char* buffer_;
+    size_t capacity_;
+    size_t size_ = 0;
+    bool overflow_ = false;
+    bool need_comma_ = false;
+
+    void Separator();
+    void Put(char c);
+    void Append(const char* data, size_t length);
+    void AppendEscaped(const char* value, size_t length);
+};
+
+// 缓冲区位于对象内部，适合放在栈上生成短小的控制消息
+template <size_t N>
+class StaticJsonWriter : public JsonWriter {
+public:
+    StaticJsonWriter() : JsonWriter(storage_, N) {}
+
+private:
+    char storage_[N];
+};
+
+// 缓冲区在堆上一次性分配，适合长度事先未知的消息
+class HeapJsonWriter : public JsonWriter {
+public:
+    explicit HeapJsonWriter(size_t capacity);
+
+    // 按 initial_capacity 写入，缓冲区不足时容量加倍后重写
+    static std::string Write(size_t initial_capacity, const std::function<void(JsonWriter& writer)>& write);
+
+private:
+    std::unique_ptr<char[]> storage_;
+
+    HeapJsonWriter(std::unique_ptr<char[]> storage, size_t capacity);
+};
+
+#endif // _JSON_WRITER_H_
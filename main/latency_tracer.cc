@@ -0,0 +1,91 @@
+#include "latency_tracer.h"
+
+#include <esp_log.h>
+#include <cinttypes>
+#include <memory>
+
+#define TAG "LatencyTracer"
+
+static const char* const TRACE_EVENT_NAMES[] = {
+    "audio_captured",
+    "audio_encoded",
+    "audio_sent",
+    "tts_start",
+    "tts_stop",
+    "audio_received",
+    "audio_decoded",
+    "audio_output",
+    "abort_speaking",
+    "output_flushed",
+};
+
+// 上行、控制、下行分别显示在不同的线程轨道上
+static const int TRACE_EVENT_TIDS[] = { 1, 1, 1, 2, 2, 3, 3, 3, 2, 3 };
+
+void LatencyTracer::BeginTurn() {
+    turn_++;
+}
+
+void LatencyTracer::Record(TraceEventType type) {
+    TraceEvent event = { esp_timer_get_time(), turn_, type };
+    taskENTER_CRITICAL(&lock_);
+    events_[write_index_++ % LATENCY_TRACE_CAPACITY] = event;
+    taskEXIT_CRITICAL(&lock_);
+}
+
+void LatencyTracer::Clear() {
+    taskENTER_CRITICAL(&lock_);
+    write_index_ = 0;
+    taskEXIT_CRITICAL(&lock_);
+}
+
+std::string LatencyTracer::ExportChromeTrace() {
+    // 先在锁内按时间顺序复制一份快照，生成 JSON 期间继续记录的事件不会覆盖正在读取的数据
+    auto snapshot = std::make_unique<TraceEvent[]>(LATENCY_TRACE_CAPACITY);
+    taskENTER_CRITICAL(&lock_);
+    uint32_t end = write_index_;
+    uint32_t count = end > LATENCY_TRACE_CAPACITY ? LATENCY_TRACE_CAPACITY : end;
+    for (uint32_t i = 0; i < count; i++) {
+        snapshot[i] = events_[(end - count + i) % LATENCY_TRACE_CAPACITY];
+    }
+    taskEXIT_CRITICAL(&lock_);
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char buffer[160];
+
+    // 每轮的嘴到耳延迟：最后一帧上行音频发送 → 第一帧下行音频写入 I2S
+    uint32_t current_turn = UINT32_MAX;
+    int64_t last_sent_us = -1;
+    bool output_seen = false;
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent& event = snapshot[i];
+        if (event.type >= kTraceEventTypeCount) {
+            continue;
+        }
+        snprintf(buffer, sizeof(buffer),
+            "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%d,\"args\":{\"turn\":%" PRIu32 "}},",
+            TRACE_EVENT_NAMES[event.type], event.timestamp_us, TRACE_EVENT_TIDS[event.type], event.turn);
+        json += buffer;
+
+        if (event.turn != current_turn) {
+            current_turn = event.turn;
+            last_sent_us = -1;
+            output_seen = false;
+        }
+        if (event.type == kTraceAudioSent) {
+            last_sent_us = event.timestamp_us;
+        } else if (event.type == kTraceAudioOutput && !output_seen && last_sent_us >= 0) {
+            output_seen = true;
+            snprintf(buffer, sizeof(buffer),
+                "{\"name\":\"mouth_to_ear\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%" PRId64 ",\"pid\":1,\"tid\":4,\"args\":{\"turn\":%" PRIu32 "}},",
+                last_sent_us, event.timestamp_us - last_sent_us, event.turn);
+            json += buffer;
+            ESP_LOGI(TAG, "Turn %" PRIu32 " mouth to ear: %" PRId64 " ms", event.turn, (event.timestamp_us - last_sent_us) / 1000);
+        }
+    }
+    if (json.back() == ',') {
+        json.pop_back();
+    }
+    json += "]}";
+    return json;
+}
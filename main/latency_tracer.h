@@ -0,0 +1,68 @@
+#ifndef _LATENCY_TRACER_H_
+#define _LATENCY_TRACER_H_
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include <string>
+#include <atomic>
+
+#define LATENCY_TRACE_CAPACITY 512
+
+enum TraceEventType : uint8_t {
+    kTraceAudioCaptured,
+    kTraceAudioEncoded,
+    kTraceAudioSent,
+    kTraceTtsStart,
+    kTraceTtsStop,
+    kTraceAudioReceived,
+    kTraceAudioDecoded,
+    kTraceAudioOutput,
+    kTraceAbortSpeaking,
+    kTraceOutputFlushed,
+    kTraceEventTypeCount
+};
+
+struct TraceEvent {
+    int64_t timestamp_us;
+    uint32_t turn;
+    TraceEventType type;
+};
+
+// 麦克风到扬声器的端到端延迟追踪
+// 事件写入固定大小的环形缓冲区，以对话轮次作为关联 ID，可导出为 Chrome trace JSON
+// 写入和导出快照都在自旋锁内完成，导出时不会读到正在写入的事件
+class LatencyTracer {
+public:
+    static LatencyTracer& GetInstance() {
+        static LatencyTracer instance;
+        return instance;
+    }
+    // 删除拷贝构造函数和赋值运算符
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+    // 开始新的对话轮次，之后记录的事件都关联到该轮次
+    void BeginTurn();
+    void Record(TraceEventType type);
+    void Clear();
+    std::string ExportChromeTrace();
+
+private:
+    LatencyTracer() = default;
+
+    portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+    TraceEvent events_[LATENCY_TRACE_CAPACITY];
+    uint32_t write_index_ = 0;
+    std::atomic<uint32_t> turn_{0};
+};
+
+#if CONFIG_USE_LATENCY_TRACE
+#define LATENCY_TRACE(type) LatencyTracer::GetInstance().Record(type)
+#define LATENCY_TRACE_BEGIN_TURN() LatencyTracer::GetInstance().BeginTurn()
+#else
+#define LATENCY_TRACE(type)
+#define LATENCY_TRACE_BEGIN_TURN()
+#endif
+
+#endif // _LATENCY_TRACER_H_
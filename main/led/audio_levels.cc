@@ -0,0 +1,73 @@
+#include "audio_levels.h"
+
+#include <cmath>
+
+// 频段分界频率 (Hz)
+static const int BAND_CUTOFFS[AUDIO_LEVEL_BANDS - 1] = { 300, 1000, 3000 };
+
+// 把归一化的能量 (满幅正弦为 1) 换算成 -60 dBFS 到 0 dBFS 的 0-255
+static uint8_t PowerToLevel(float power) {
+    if (power <= 1e-6f) {
+        return 0;
+    }
+    float db = 10.0f * log10f(power);
+    if (db >= 0.0f) {
+        return 255;
+    }
+    return static_cast<uint8_t>((db + 60.0f) * 255.0f / 60.0f);
+}
+
+AudioLevels AudioLevelAnalyzer::Analyze(const int16_t* pcm, size_t samples, int stride, int sample_rate) {
+    AudioLevels levels;
+    size_t count = samples / stride;
+    if (count == 0 || sample_rate <= 0) {
+        return levels;
+    }
+
+    // 一阶低通 y += a * (x - y)，系数 a = 1 - exp(-2 * pi * fc / fs) 使用 Q15 定点数
+    if (sample_rate != sample_rate_) {
+        sample_rate_ = sample_rate;
+        for (int b = 0; b < AUDIO_LEVEL_BANDS - 1; b++) {
+            alpha_[b] = static_cast<int32_t>(lrintf((1.0f - expf(-2.0f * M_PI * BAND_CUTOFFS[b] / sample_rate)) * 32768.0f));
+        }
+        Reset();
+    }
+
+    int32_t lowpass[AUDIO_LEVEL_BANDS - 1];
+    for (int b = 0; b < AUDIO_LEVEL_BANDS - 1; b++) {
+        lowpass[b] = lowpass_[b];
+    }
+    int64_t energy[AUDIO_LEVEL_BANDS] = {};
+    int64_t sum_squares = 0;
+    for (size_t i = 0; i < count; i++) {
+        int32_t x = pcm[i * stride];
+        sum_squares += x * x;
+        int32_t previous = 0;
+        for (int b = 0; b < AUDIO_LEVEL_BANDS - 1; b++) {
+            lowpass[b] += (alpha_[b] * (x - lowpass[b])) >> 15;
+            // 相邻两个低通的差就是两者截止频率之间的频段
+            int32_t band = lowpass[b] - previous;
+            energy[b] += (int64_t)band * band;
+            previous = lowpass[b];
+        }
+        int32_t high = x - previous;
+        energy[AUDIO_LEVEL_BANDS - 1] += (int64_t)high * high;
+    }
+    for (int b = 0; b < AUDIO_LEVEL_BANDS - 1; b++) {
+        lowpass_[b] = lowpass[b];
+    }
+
+    // 满幅正弦的均方值为 32768^2 / 2
+    const float full_scale = count * 32768.0f * 32768.0f / 2.0f;
+    levels.rms = PowerToLevel(sum_squares / full_scale);
+    for (int b = 0; b < AUDIO_LEVEL_BANDS; b++) {
+        levels.bands[b] = PowerToLevel(energy[b] / full_scale);
+    }
+    return levels;
+}
+
+void AudioLevelAnalyzer::Reset() {
+    for (int b = 0; b < AUDIO_LEVEL_BANDS - 1; b++) {
+        lowpass_[b] = 0;
+    }
+}
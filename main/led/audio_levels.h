@@ -0,0 +1,35 @@
+#ifndef _AUDIO_LEVELS_H_
+#define _AUDIO_LEVELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#define AUDIO_LEVEL_BANDS 4
+
+// 音频可视化时灯效响度每帧最多下降的值，上升立即跟随
+#define LED_AUDIO_LEVEL_DECAY 24
+
+// 一帧音频的响度和频段能量，按 -60 dBFS 到 0 dBFS 映射到 0-255
+struct AudioLevels {
+    uint8_t rms = 0;
+    // 依次为 300 Hz 以下、300-1000 Hz、1000-3000 Hz、3000 Hz 以上
+    uint8_t bands[AUDIO_LEVEL_BANDS] = {};
+};
+
+// 灯效用的轻量频谱分析：三个截止频率不同、输入都是原信号的并联定点一阶低通，相邻输出相减得到四个频段，
+// 每个采样只做几次整数乘加，比完整 FFT 便宜得多，直接在已有的输入输出音频帧上计算
+// 滤波器状态在帧之间保留，每路音频流使用各自的实例
+class AudioLevelAnalyzer {
+public:
+    // stride 为交错多声道数据中相邻两个采样的间隔，只分析第一个声道
+    AudioLevels Analyze(const int16_t* pcm, size_t samples, int stride, int sample_rate);
+    // 清空滤波器状态，采样率变化时自动调用
+    void Reset();
+
+private:
+    int sample_rate_ = 0;
+    int32_t alpha_[AUDIO_LEVEL_BANDS - 1] = {};
+    int32_t lowpass_[AUDIO_LEVEL_BANDS - 1] = {};
+};
+
+#endif // _AUDIO_LEVELS_H_
@@ -1,6 +1,10 @@
 #include "circular_strip.h"
 #include "application.h"
 #include <esp_log.h>
+#include <soc/soc_caps.h>
+
+#include <algorithm>
+#include <cstdlib>
 
 #define TAG "CircularStrip"
 
@@ -8,9 +12,8 @@
 #define HIGH_BRIGHTNESS 16
 #define LOW_BRIGHTNESS 1
 
-#define BLINK_INFINITE -1
-
-CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds) : max_leds_(max_leds) {
+CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds)
+    : max_leds_(max_leds), player_([this](const StripColor* colors, int count) { Show(colors, count); }) {
     // If the gpio is not connected, you should use NoLed class
     assert(gpio != GPIO_NUM_NC);
 
@@ -24,158 +27,141 @@ CircularStrip::CircularStrip(gpio_num_t gpio, uint8_t max_leds) : max_leds_(max_
 
     led_strip_rmt_config_t rmt_config = {};
     rmt_config.resolution_hz = 10 * 1000 * 1000; // 10MHz
+#if SOC_RMT_SUPPORT_DMA
+    // 整帧通过 DMA 发送，刷新期间不占用 RMT 中断
+    rmt_config.mem_block_symbols = 1024;
+    rmt_config.flags.with_dma = true;
+#endif
 
     ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip_));
     led_strip_clear(led_strip_);
-
-    esp_timer_create_args_t strip_timer_args = {
-        .callback = [](void *arg) {
-            auto strip = static_cast<CircularStrip*>(arg);
-            std::lock_guard<std::mutex> lock(strip->mutex_);
-            if (strip->strip_callback_ != nullptr) {
-                strip->strip_callback_();
-            }
-        },
-        .arg = this,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "strip_timer",
-        .skip_unhandled_events = false,
-    };
-    ESP_ERROR_CHECK(esp_timer_create(&strip_timer_args, &strip_timer_));
 }
 
 CircularStrip::~CircularStrip() {
-    esp_timer_stop(strip_timer_);
+    player_.Stop();
     if (led_strip_ != nullptr) {
         led_strip_del(led_strip_);
     }
 }
 
-
-void CircularStrip::StaticColor(StripColor color) {
+// 在 LedAnimator 的定时器中调用
+void CircularStrip::Show(const StripColor* colors, int count) {
     std::lock_guard<std::mutex> lock(mutex_);
-    esp_timer_stop(strip_timer_);
+    for (int i = 0; i < count && i < max_leds_; i++) {
+        colors_[i] = colors[i];
+    }
+    Refresh();
+}
+
+void CircularStrip::Refresh() {
     for (int i = 0; i < max_leds_; i++) {
-        colors_[i] = color;
-        led_strip_set_pixel(led_strip_, i, color.red, color.green, color.blue);
+        led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
     }
     led_strip_refresh(led_strip_);
 }
 
+void CircularStrip::StaticColor(StripColor color) {
+    player_.Stop();
+    std::vector<StripColor> colors(max_leds_, color);
+    Show(colors.data(), max_leds_);
+}
+
 void CircularStrip::Blink(StripColor color, int interval_ms) {
-    for (int i = 0; i < max_leds_; i++) {
-        colors_[i] = color;
-    }
-    StartStripTask(interval_ms, [this]() {
-        static bool on = true;
-        if (on) {
-            for (int i = 0; i < max_leds_; i++) {
-                led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-            }
-            led_strip_refresh(led_strip_);
-        } else {
-            led_strip_clear(led_strip_);
-        }
-        on = !on;
-    });
+    LedAnimationSpec spec;
+    spec.keyframes = {
+        { 0, color },
+        { interval_ms, {} },
+        { interval_ms * 2, {} },
+    };
+    spec.easing = kLedEasingStep;
+    spec.frame_interval_ms = interval_ms;
+    player_.Play(LedAnimation::Build(spec, max_leds_));
 }
 
 void CircularStrip::FadeOut(int interval_ms) {
-    StartStripTask(interval_ms, [this]() {
-        bool all_off = true;
-        for (int i = 0; i < max_leds_; i++) {
-            colors_[i].red /= 2;
-            colors_[i].green /= 2;
-            colors_[i].blue /= 2;
-            if (colors_[i].red != 0 || colors_[i].green != 0 || colors_[i].blue != 0) {
-                all_off = false;
-            }
-            led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-        }
-        if (all_off) {
-            led_strip_clear(led_strip_);
-            esp_timer_stop(strip_timer_);
-        } else {
-            led_strip_refresh(led_strip_);
-        }
-    });
+    std::vector<StripColor> from;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        from = colors_;
+    }
+    // 原来每个周期亮度减半，8 个周期后全部熄灭
+    LedAnimationSpec spec;
+    spec.keyframes = {
+        { 0, {} },
+        { interval_ms * 8, {} },
+    };
+    spec.frame_interval_ms = interval_ms;
+    spec.loop = false;
+    player_.Play(LedAnimation::Build(spec, max_leds_, &from));
 }
 
 void CircularStrip::Breathe(StripColor low, StripColor high, int interval_ms) {
-    StartStripTask(interval_ms, [this, low, high]() {
-        static bool increase = true;
-        static StripColor color = low;
-        if (increase) {
-            if (color.red < high.red) {
-                color.red++;
-            }
-            if (color.green < high.green) {
-                color.green++;
-            }
-            if (color.blue < high.blue) {
-                color.blue++;
-            }
-            if (color.red == high.red && color.green == high.green && color.blue == high.blue) {
-                increase = false;
-            }
-        } else {
-            if (color.red > low.red) {
-                color.red--;
-            }
-            if (color.green > low.green) {
-                color.green--;
-            }
-            if (color.blue > low.blue) {
-                color.blue--;
-            }
-            if (color.red == low.red && color.green == low.green && color.blue == low.blue) {
-                increase = true;
-            }
-        }
-        for (int i = 0; i < max_leds_; i++) {
-            led_strip_set_pixel(led_strip_, i, color.red, color.green, color.blue);
-        }
-        led_strip_refresh(led_strip_);
-    });
+    // 每个周期变化 1 级亮度，一次呼吸的时长由变化最大的通道决定
+    int steps = std::max({ abs(high.red - low.red), abs(high.green - low.green), abs(high.blue - low.blue), 1 });
+    LedAnimationSpec spec;
+    spec.keyframes = {
+        { 0, low },
+        { steps * interval_ms, high },
+        { steps * interval_ms * 2, low },
+    };
+    spec.easing = kLedEasingInOut;
+    spec.frame_interval_ms = interval_ms;
+    player_.Play(LedAnimation::Build(spec, max_leds_));
 }
 
 void CircularStrip::Scroll(StripColor low, StripColor high, int length, int interval_ms) {
-    for (int i = 0; i < max_leds_; i++) {
-        colors_[i] = low;
-    }
-    StartStripTask(interval_ms, [this, low, high, length]() {
-        static int offset = 0;
-        for (int i = 0; i < max_leds_; i++) {
-            colors_[i] = low;
-        }
-        for (int j = 0; j < length; j++) {
-            int i = (offset + j) % max_leds_;
-            colors_[i] = high;
-        }
-        for (int i = 0; i < max_leds_; i++) {
-            led_strip_set_pixel(led_strip_, i, colors_[i].red, colors_[i].green, colors_[i].blue);
-        }
-        led_strip_refresh(led_strip_);
-        offset = (offset + 1) % max_leds_;
-    });
+    // 每个周期亮段前进一个灯：每个灯在一圈中依次亮 length 个周期，相邻灯错开一个周期
+    int period_ms = max_leds_ * interval_ms;
+    LedAnimationSpec spec;
+    spec.keyframes = {
+        { 0, high },
+        { interval_ms, low },
+        { (max_leds_ - length + 1) * interval_ms, high },
+        { period_ms, high },
+    };
+    spec.easing = kLedEasingStep;
+    spec.frame_interval_ms = interval_ms;
+    spec.pixel_phase_ms = interval_ms;
+    player_.Play(LedAnimation::Build(spec, max_leds_));
 }
 
-void CircularStrip::StartStripTask(int interval_ms, std::function<void()> cb) {
-    if (led_strip_ == nullptr) {
+// 亮起的灯数跟随响度，颜色按频段能量着色：低频偏红，中频偏绿，高频偏蓝
+void CircularStrip::OnAudioLevels(const AudioLevels& levels, bool output) {
+    if (!(output ? visualize_output_ : visualize_input_)) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
-    esp_timer_stop(strip_timer_);
-    
-    strip_callback_ = cb;
-    esp_timer_start_periodic(strip_timer_, interval_ms * 1000);
-}
+    // 上升立即跟随，下降逐帧衰减，避免灯数抖动
+    audio_level_ = std::max<int>(levels.rms, audio_level_ - LED_AUDIO_LEVEL_DECAY);
+    int lit = (audio_level_ * max_leds_ + 127) / 255;
+    auto scale = [](int band) {
+        return static_cast<uint8_t>(LOW_BRIGHTNESS + band * (HIGH_BRIGHTNESS - LOW_BRIGHTNESS) / 255);
+    };
+    StripColor color = {
+        scale(levels.bands[0]),
+        scale((levels.bands[1] + levels.bands[2]) / 2),
+        scale(levels.bands[3]),
+    };
 
+    // 直接写入 colors_，不为每个音频帧分配临时缓冲区
+    for (int i = 0; i < max_leds_; i++) {
+        colors_[i] = i < lit ? color : StripColor{};
+    }
+    Refresh();
+}
 
 void CircularStrip::OnStateChanged() {
     auto& app = Application::GetInstance();
     auto device_state = app.GetDeviceState();
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        audio_level_ = 0;
+    }
+    visualize_input_ = device_state == kDeviceStateListening;
+    visualize_output_ = device_state == kDeviceStateSpeaking;
+#endif
     switch (device_state) {
         case kDeviceStateStarting: {
             StripColor low = { 0, 0, 0 };
@@ -2,41 +2,41 @@
 #define _CIRCULAR_STRIP_H_
 
 #include "led.h"
+#include "led_animation.h"
 #include <driver/gpio.h>
 #include <led_strip.h>
-#include <esp_timer.h>
-#include <atomic>
 #include <mutex>
+#include <atomic>
 #include <vector>
 
-struct StripColor {
-    uint8_t red = 0, green = 0, blue = 0;
-};
-
 class CircularStrip : public Led {
 public:
     CircularStrip(gpio_num_t gpio, uint8_t max_leds);
     virtual ~CircularStrip();
 
     void OnStateChanged() override;
+    void OnAudioLevels(const AudioLevels& levels, bool output) override;
 
 private:
     std::mutex mutex_;
-    TaskHandle_t blink_task_ = nullptr;
     led_strip_handle_t led_strip_ = nullptr;
     int max_leds_ = 0;
+    // 灯带当前显示的颜色，淡出时从这里开始过渡
     std::vector<StripColor> colors_;
-    int blink_counter_ = 0;
-    int blink_interval_ms_ = 0;
-    esp_timer_handle_t strip_timer_ = nullptr;
-    std::function<void()> strip_callback_ = nullptr;
+    LedAnimationPlayer player_;
+    // 聆听和说话时跟随音频，其余状态为 false
+    std::atomic<bool> visualize_input_{false};
+    std::atomic<bool> visualize_output_{false};
+    // 受 mutex_ 保护
+    uint8_t audio_level_ = 0;
 
-    void StartStripTask(int interval_ms, std::function<void()> cb);
+    void Show(const StripColor* colors, int count);
+    // 调用者需持有 mutex_，把 colors_ 写入灯带
+    void Refresh();
 
     void StaticColor(StripColor color);
     void Blink(StripColor color, int interval_ms);
     void Breathe(StripColor low, StripColor high, int interval_ms);
-    void Rainbow(StripColor low, StripColor high, int interval_ms);
     void Scroll(StripColor low, StripColor high, int length, int interval_ms);
     void FadeOut(int interval_ms);
 };
@@ -1,11 +1,15 @@
 #ifndef _LED_H_
 #define _LED_H_
 
+#include "audio_levels.h"
+
 class Led {
 public:
     virtual ~Led() = default;
     // Set the led state based on the device state
     virtual void OnStateChanged() = 0;
+    // 开启 CONFIG_USE_LED_AUDIO_VISUALIZER 时每个音频帧调用一次，output 为 true 表示 TTS 播放，否则为麦克风输入
+    virtual void OnAudioLevels(const AudioLevels& levels, bool output) {}
 };
 
 
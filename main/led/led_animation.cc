@@ -0,0 +1,198 @@
+#include "led_animation.h"
+
+#include <esp_log.h>
+
+#include <algorithm>
+#include <cmath>
+
+#define TAG "LedAnimation"
+
+#define LED_GAMMA 2.2f
+
+// 人眼对亮度的感知接近幂函数，在感知空间插值可以让低亮度段的渐变同样平滑
+struct GammaTables {
+    uint8_t to_perceptual[256];
+    uint8_t to_linear[256];
+
+    GammaTables() {
+        for (int i = 0; i < 256; i++) {
+            to_perceptual[i] = static_cast<uint8_t>(roundf(255.0f * powf(i / 255.0f, 1.0f / LED_GAMMA)));
+            to_linear[i] = static_cast<uint8_t>(roundf(255.0f * powf(i / 255.0f, LED_GAMMA)));
+        }
+    }
+};
+
+static const GammaTables& GetGammaTables() {
+    static GammaTables tables;
+    return tables;
+}
+
+static uint8_t BlendChannel(uint8_t from, uint8_t to, float progress) {
+    // 两端保持原值，避免查表误差让很暗的颜色变成 0
+    if (from == to || progress <= 0.0f) {
+        return from;
+    }
+    if (progress >= 1.0f) {
+        return to;
+    }
+    auto& gamma = GetGammaTables();
+    float p0 = gamma.to_perceptual[from];
+    float p1 = gamma.to_perceptual[to];
+    return gamma.to_linear[static_cast<int>(roundf(p0 + (p1 - p0) * progress))];
+}
+
+static StripColor SampleKeyframes(const LedAnimationSpec& spec, int time_ms, const StripColor* first_color) {
+    auto& keyframes = spec.keyframes;
+    size_t next = 1;
+    while (next < keyframes.size() - 1 && keyframes[next].time_ms <= time_ms) {
+        next++;
+    }
+    auto& k0 = keyframes[next - 1];
+    auto& k1 = keyframes[next];
+    StripColor c0 = (next == 1 && first_color != nullptr) ? *first_color : k0.color;
+    if (time_ms >= k1.time_ms) {
+        return k1.color;
+    }
+    if (spec.easing == kLedEasingStep || k1.time_ms <= k0.time_ms) {
+        return c0;
+    }
+
+    float progress = static_cast<float>(time_ms - k0.time_ms) / (k1.time_ms - k0.time_ms);
+    if (spec.easing == kLedEasingInOut) {
+        progress = progress * progress * (3.0f - 2.0f * progress);
+    }
+    return {
+        BlendChannel(c0.red, k1.color.red, progress),
+        BlendChannel(c0.green, k1.color.green, progress),
+        BlendChannel(c0.blue, k1.color.blue, progress),
+    };
+}
+
+LedAnimation LedAnimation::Build(const LedAnimationSpec& spec, int pixels, const std::vector<StripColor>* from) {
+    LedAnimation animation;
+    animation.pixels_ = pixels;
+    animation.loop_ = spec.loop;
+    int ticks = std::max(1, (spec.frame_interval_ms + LED_ANIMATION_TICK_MS / 2) / LED_ANIMATION_TICK_MS);
+    animation.frame_interval_ms_ = ticks * LED_ANIMATION_TICK_MS;
+    if (spec.keyframes.empty() || pixels <= 0) {
+        return animation;
+    }
+    if (spec.keyframes.size() == 1) {
+        animation.frame_count_ = 1;
+        animation.frames_.assign(pixels, spec.keyframes[0].color);
+        return animation;
+    }
+
+    // 循环动画的最后一个关键帧与第一帧重合，不重复生成；单次动画停在最后一帧
+    int duration_ms = spec.keyframes.back().time_ms;
+    int interval_ms = animation.frame_interval_ms_;
+    animation.frame_count_ = spec.loop ? std::max(1, duration_ms / interval_ms) : duration_ms / interval_ms + 1;
+    animation.frames_.resize(animation.frame_count_ * pixels);
+
+    for (int f = 0; f < animation.frame_count_; f++) {
+        int time_ms = f * interval_ms;
+        for (int i = 0; i < pixels; i++) {
+            int pixel_time_ms = time_ms - i * spec.pixel_phase_ms;
+            if (spec.loop && duration_ms > 0) {
+                pixel_time_ms = ((pixel_time_ms % duration_ms) + duration_ms) % duration_ms;
+            } else {
+                pixel_time_ms = std::clamp(pixel_time_ms, 0, duration_ms);
+            }
+            const StripColor* first_color = (from != nullptr && i < (int)from->size()) ? &(*from)[i] : nullptr;
+            animation.frames_[f * pixels + i] = SampleKeyframes(spec, pixel_time_ms, first_color);
+        }
+    }
+    ESP_LOGD(TAG, "Built %d frames x %d pixels, %d ms per frame", animation.frame_count_, pixels, interval_ms);
+    return animation;
+}
+
+LedAnimationPlayer::LedAnimationPlayer(std::function<void(const StripColor* colors, int count)> output)
+    : output_(output) {
+}
+
+LedAnimationPlayer::~LedAnimationPlayer() {
+    Stop();
+}
+
+void LedAnimationPlayer::Play(LedAnimation&& animation) {
+    LedAnimator::GetInstance().Start(this, std::move(animation));
+}
+
+void LedAnimationPlayer::Stop() {
+    LedAnimator::GetInstance().Stop(this);
+}
+
+LedAnimator::LedAnimator() {
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void *arg) {
+            auto animator = static_cast<LedAnimator*>(arg);
+            animator->OnTick();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led_animator",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer_));
+}
+
+LedAnimator::~LedAnimator() {
+    if (timer_ != nullptr) {
+        esp_timer_stop(timer_);
+        esp_timer_delete(timer_);
+    }
+}
+
+void LedAnimator::Start(LedAnimationPlayer* player, LedAnimation&& animation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    player->animation_ = std::move(animation);
+    player->frame_ = 0;
+    player->ticks_until_next_ = 1;
+    if (std::find(players_.begin(), players_.end(), player) == players_.end()) {
+        players_.push_back(player);
+    }
+    if (!running_) {
+        running_ = true;
+        esp_timer_start_periodic(timer_, LED_ANIMATION_TICK_MS * 1000);
+    }
+}
+
+void LedAnimator::Stop(LedAnimationPlayer* player) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    players_.remove(player);
+    if (running_ && players_.empty()) {
+        running_ = false;
+        esp_timer_stop(timer_);
+    }
+}
+
+void LedAnimator::OnTick() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = players_.begin(); it != players_.end();) {
+        auto player = *it;
+        if (--player->ticks_until_next_ > 0) {
+            ++it;
+            continue;
+        }
+
+        auto& animation = player->animation_;
+        if (animation.frame_count() > 0) {
+            player->output_(animation.frame(player->frame_), animation.pixels());
+        }
+        player->ticks_until_next_ = animation.frame_interval_ms() / LED_ANIMATION_TICK_MS;
+        player->frame_++;
+        if (player->frame_ >= animation.frame_count()) {
+            if (!animation.loop() || animation.frame_count() <= 1) {
+                // 单次动画和静态帧播放完就移除，不再占用定时器
+                it = players_.erase(it);
+                continue;
+            }
+            player->frame_ = 0;
+        }
+        ++it;
+    }
+    if (running_ && players_.empty()) {
+        running_ = false;
+        esp_timer_stop(timer_);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef _LED_ANIMATION_H_
+#define _LED_ANIMATION_H_
+
+#include <esp_timer.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <vector>
+
+// 所有灯效共用的驱动定时器周期，每个动画的帧间隔取整到它的倍数
+#define LED_ANIMATION_TICK_MS 10
+
+struct StripColor {
+    uint8_t red = 0, green = 0, blue = 0;
+};
+
+enum LedEasing {
+    kLedEasingStep,     // 保持上一关键帧的颜色直到下一关键帧
+    kLedEasingLinear,   // 在感知亮度上线性过渡
+    kLedEasingInOut,    // 两端慢中间快，用于呼吸效果
+};
+
+struct LedKeyframe {
+    int time_ms;
+    StripColor color;
+};
+
+// 声明式的灯效描述：关键帧按时间递增，第一帧时间为 0，最后一帧的时间即动画时长
+struct LedAnimationSpec {
+    std::vector<LedKeyframe> keyframes;
+    LedEasing easing = kLedEasingLinear;
+    int frame_interval_ms = 20;
+    bool loop = true;
+    // 第 i 个灯在时间轴上落后 i * pixel_phase_ms，用于流水、跑马灯效果
+    int pixel_phase_ms = 0;
+};
+
+// 预先计算好的帧表，播放时只需把整帧颜色送给灯带，不再逐步计算
+class LedAnimation {
+public:
+    // from 不为空时，每个灯从 from 中的颜色过渡到第一个关键帧之后的颜色，用于从当前画面淡出
+    static LedAnimation Build(const LedAnimationSpec& spec, int pixels, const std::vector<StripColor>* from = nullptr);
+
+    inline int frame_count() const { return frame_count_; }
+    inline int pixels() const { return pixels_; }
+    inline int frame_interval_ms() const { return frame_interval_ms_; }
+    inline bool loop() const { return loop_; }
+    inline const StripColor* frame(int index) const { return &frames_[index * pixels_]; }
+
+private:
+    std::vector<StripColor> frames_;
+    int frame_count_ = 0;
+    int pixels_ = 0;
+    int frame_interval_ms_ = LED_ANIMATION_TICK_MS;
+    bool loop_ = false;
+};
+
+// 单个灯的播放状态，由拥有灯带的对象持有，输出回调负责把一帧颜色写入硬件
+class LedAnimationPlayer {
+public:
+    explicit LedAnimationPlayer(std::function<void(const StripColor* colors, int count)> output);
+    ~LedAnimationPlayer();
+
+    void Play(LedAnimation&& animation);
+    void Stop();
+
+private:
+    friend class LedAnimator;
+    std::function<void(const StripColor* colors, int count)> output_;
+    LedAnimation animation_;
+    int frame_ = 0;
+    int ticks_until_next_ = 0;
+};
+
+// 用一个定时器驱动所有正在播放的灯效，没有动画时停止定时器
+class LedAnimator {
+public:
+    static LedAnimator& GetInstance() {
+        static LedAnimator instance;
+        return instance;
+    }
+    // 删除拷贝构造函数和赋值运算符
+    LedAnimator(const LedAnimator&) = delete;
+    LedAnimator& operator=(const LedAnimator&) = delete;
+
+private:
+    friend class LedAnimationPlayer;
+    LedAnimator();
+    ~LedAnimator();
+
+    std::mutex mutex_;
+    std::list<LedAnimationPlayer*> players_;
+    esp_timer_handle_t timer_ = nullptr;
+    bool running_ = false;
+
+    void Start(LedAnimationPlayer* player, LedAnimation&& animation);
+    void Stop(LedAnimationPlayer* player);
+    void OnTick();
+};
+
+#endif // _LED_ANIMATION_H_
@@ -2,6 +2,8 @@
 #include "application.h"
 #include <esp_log.h> 
 
+#include <algorithm>
+
 #define TAG "SingleLed"
 
 #define DEFAULT_BRIGHTNESS 4
@@ -116,9 +118,30 @@ void SingleLed::OnBlinkTimer() {
 }
 
 
+void SingleLed::OnAudioLevels(const AudioLevels& levels, bool output) {
+    if (!(output ? visualize_output_ : visualize_input_)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 亮度在当前颜色的 1 到 4 倍之间跟随响度，上升立即跟随，下降逐帧衰减
+    audio_level_ = std::max<int>(levels.rms, audio_level_ - LED_AUDIO_LEVEL_DECAY);
+    int scale = 256 + audio_level_ * 3;
+    led_strip_set_pixel(led_strip_, 0, (r_ * scale) >> 8, (g_ * scale) >> 8, (b_ * scale) >> 8);
+    led_strip_refresh(led_strip_);
+}
+
 void SingleLed::OnStateChanged() {
     auto& app = Application::GetInstance();
     auto device_state = app.GetDeviceState();
+#if CONFIG_USE_LED_AUDIO_VISUALIZER
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        audio_level_ = 0;
+    }
+    visualize_input_ = device_state == kDeviceStateListening;
+    visualize_output_ = device_state == kDeviceStateSpeaking;
+#endif
     switch (device_state) {
         case kDeviceStateStarting:
             SetColor(0, 0, DEFAULT_BRIGHTNESS);
@@ -14,6 +14,7 @@ public:
     virtual ~SingleLed();
 
     void OnStateChanged() override;
+    void OnAudioLevels(const AudioLevels& levels, bool output) override;
 
 private:
     std::mutex mutex_;
@@ -23,6 +24,11 @@ private:
     int blink_counter_ = 0;
     int blink_interval_ms_ = 0;
     esp_timer_handle_t blink_timer_ = nullptr;
+    // 聆听和说话时亮度跟随音频，其余状态为 false
+    std::atomic<bool> visualize_input_{false};
+    std::atomic<bool> visualize_output_{false};
+    // 受 mutex_ 保护
+    uint8_t audio_level_ = 0;
 
     void StartBlinkTask(int times, int interval_ms);
     void OnBlinkTimer();
@@ -5,6 +5,8 @@
 #include "board.h"
 #include "application.h"
 #include "audio_codecs/audio_codec.h"
+#include "latency_tracer.h"
+#include "json_writer.h"
 
 #include <esp_log.h>
 #include <esp_http_server.h>
@@ -20,6 +22,8 @@
 #define TAG "WebSocketServer"
 #define WS_PING_INTERVAL_MS 30000 // 30秒发送一次 ping
 #define WS_PING_TIMEOUT_MS 120000 // 120秒没有响应则断开连接
+#define WS_SEND_CHUNK_SIZE 1024   // 大消息（如延迟追踪导出）分块写入 socket
+#define WS_LOG_PAYLOAD_MAX 256    // 超过该长度的消息只打印长度
 
 // 添加 WebSocket 帧解析相关的结构和常量
 #define WS_FIN 0x80
@@ -362,66 +366,69 @@ static esp_err_t HandleAllRequests(httpd_req_t *req)
     return ESP_OK;
 }
 
+// 循环发送直到全部写入，send 可能只发送一部分数据
+static bool SendAll(int sock, const uint8_t *data, size_t len)
+{
+    while (len > 0)
+    {
+        size_t chunk = len > WS_SEND_CHUNK_SIZE ? WS_SEND_CHUNK_SIZE : len;
+        int ret = send(sock, data, chunk, 0);
+        if (ret < 0)
+        {
+            ESP_LOGE(TAG, "Failed to send WebSocket message: errno %d", errno);
+            return false;
+        }
+        data += ret;
+        len -= ret;
+    }
+    return true;
+}
+
 // 添加发送 WebSocket 消息的辅助函数
+// 帧头和消息分开发送，消息直接从调用者的缓冲区分块写入 socket，不再复制整个帧
 static esp_err_t SendWebSocketMessage(int sock, const char *message, size_t len)
 {
-    ESP_LOGI(TAG, "Sending message: %s", message); // 添加日志
-
-    // 计算帧头大小
-    size_t header_len = 2;
-    if (len > 125)
+    if (len <= WS_LOG_PAYLOAD_MAX)
     {
-        header_len += (len > 65535) ? 8 : 2;
+        ESP_LOGI(TAG, "Sending message: %.*s", (int)len, message);
     }
-
-    // 分配帧缓冲区
-    uint8_t *frame = (uint8_t *)malloc(header_len + len);
-    if (!frame)
+    else
     {
-        ESP_LOGE(TAG, "Failed to allocate frame buffer");
-        return ESP_FAIL;
+        ESP_LOGI(TAG, "Sending message: %u bytes", (unsigned)len);
     }
 
     // 设置帧头
-    frame[0] = WS_FIN | WS_OPCODE_TEXT;
+    uint8_t header[10];
+    size_t header_len = 2;
+    header[0] = WS_FIN | WS_OPCODE_TEXT;
 
     // 设置长度
     if (len <= 125)
     {
-        frame[1] = len;
+        header[1] = len;
     }
     else if (len <= 65535)
     {
-        frame[1] = 126;
-        frame[2] = (len >> 8) & 0xFF;
-        frame[3] = len & 0xFF;
+        header[1] = 126;
+        header[2] = (len >> 8) & 0xFF;
+        header[3] = len & 0xFF;
+        header_len += 2;
     }
     else
     {
-        frame[1] = 127;
+        header[1] = 127;
         for (int i = 0; i < 8; i++)
         {
-            frame[2 + i] = (len >> ((7 - i) * 8)) & 0xFF;
+            header[2 + i] = ((uint64_t)len >> ((7 - i) * 8)) & 0xFF;
         }
+        header_len += 8;
     }
 
-    // 复制消息数据
-    memcpy(frame + header_len, message, len);
-
-    // 发送帧
-    ESP_LOGI(TAG, "Sending frame with length: %d", header_len + len); // 添加日志
-    int ret = send(sock, frame, header_len + len, 0);
-    if (ret < 0)
+    if (!SendAll(sock, header, header_len) || !SendAll(sock, (const uint8_t *)message, len))
     {
-        ESP_LOGE(TAG, "Failed to send WebSocket message: errno %d", errno);
-    }
-    else
-    {
-        ESP_LOGI(TAG, "Successfully sent %d bytes", ret);
+        return ESP_FAIL;
     }
-
-    free(frame);
-    return (ret < 0) ? ESP_FAIL : ESP_OK;
+    return ESP_OK;
 }
 
 // 添加一个辅助函数来检查键的长度
@@ -430,6 +437,17 @@ bool IsValidNvsKey(const char *key)
     return strlen(key) <= 15; // NVS 键的最大长度是 15 字符
 }
 
+// 发送 JsonWriter 生成的消息，缓冲区不足时不发送
+static esp_err_t SendJsonMessage(int sock, const JsonWriter &writer)
+{
+    if (!writer.ok())
+    {
+        ESP_LOGE(TAG, "JSON response exceeds %u bytes", (unsigned)writer.capacity());
+        return ESP_FAIL;
+    }
+    return SendWebSocketMessage(sock, writer.c_str(), writer.size());
+}
+
 // 处理 JSON 消息
 static esp_err_t HandleJsonMessage(int sock, const char *message)
 {
@@ -462,109 +480,63 @@ static esp_err_t HandleJsonMessage(int sock, const char *message)
 
     if (strcmp(type->valuestring, "get_config") == 0)
     {
-        // 创建响应
-        cJSON *response = cJSON_CreateObject();
-        if (!response)
-        {
-            ESP_LOGE(TAG, "Failed to create response object");
-            cJSON_Delete(root);
-            return ESP_FAIL;
-        }
-
-        cJSON_AddStringToObject(response, "type", "get_config");
-
-        // 添加配置数据
-        cJSON *config = cJSON_CreateObject();
-        if (!config)
-        {
-            ESP_LOGE(TAG, "Failed to create config object");
-            cJSON_Delete(response);
-            cJSON_Delete(root);
-            return ESP_FAIL;
-        }
-
-        // 从 Settings 获取 WiFi 配置
         Settings wifi_settings("wifi");
-        cJSON_AddStringToObject(config, "ssid", wifi_settings.GetString("ssid", "").c_str());
-        cJSON_AddStringToObject(config, "password", wifi_settings.GetString("password", "").c_str());
-        cJSON_AddStringToObject(config, "hostname", wifi_settings.GetString("hostname", "xiaozhi").c_str());
-
-        // 添加 WiFi 连接状态
-        cJSON_AddBoolToObject(config, "wifi_connected", WifiStation::GetInstance().IsConnected());
-
-        // 添加系统信息
-        cJSON_AddStringToObject(config, "mac_address", SystemInfo::GetMacAddress().c_str());
-        cJSON_AddStringToObject(config, "chip_model", SystemInfo::GetChipModelName().c_str());
-        cJSON_AddNumberToObject(config, "free_heap", SystemInfo::GetFreeHeapSize());
-
-        // 添加自定义配置
         Settings custom_settings("custom");
-        cJSON *custom_config = cJSON_CreateObject();
-        if (custom_config)
-        {
+
+        // 定义所有可能的键
+        const char *string_keys[] = {
+            "welcomeWord", "sleepWord", "waitWord", "roleWord",
+            "wakeupWord", "failWord", "voice", "botId", "apiToken"};
+        const char *int_keys[] = {
+            "emotion", "language", "speed", "tone", "model"};
+
+        std::string response = HeapJsonWriter::Write(1024, [&](JsonWriter &writer)
+                                                      {
+            writer.BeginObject().AddString("type", "get_config");
+
+            // 从 Settings 获取 WiFi 配置
+            writer.Key("config").BeginObject()
+                .AddString("ssid", wifi_settings.GetString("ssid", ""))
+                .AddString("password", wifi_settings.GetString("password", ""))
+                .AddString("hostname", wifi_settings.GetString("hostname", "xiaozhi"))
+                // 添加 WiFi 连接状态
+                .AddBool("wifi_connected", WifiStation::GetInstance().IsConnected())
+                // 添加系统信息
+                .AddString("mac_address", SystemInfo::GetMacAddress())
+                .AddString("chip_model", SystemInfo::GetChipModelName())
+                .AddInt("free_heap", SystemInfo::GetFreeHeapSize());
+
+            // 添加自定义配置
+            writer.Key("custom").BeginObject();
             // 获取实际设备音量
             auto codec = Board::GetInstance().GetAudioCodec();
             if (codec)
             {
-                try
-                {
-                    int current_volume = codec->output_volume();
-                    cJSON_AddNumberToObject(custom_config, "volume", current_volume);
-                    ESP_LOGI(TAG, "Current device volume: %d", current_volume);
-                }
-                catch (const std::exception &e)
-                {
-                    ESP_LOGW(TAG, "Failed to get device volume: %s", e.what());
-                    // 如果获取失败，尝试从配置中读取
-                    int saved_volume = custom_settings.GetInt("volume", 50);
-                    cJSON_AddNumberToObject(custom_config, "volume", saved_volume);
-                }
+                writer.AddInt("volume", codec->output_volume());
             }
-
-            // 定义所有可能的键
-            const char *string_keys[] = {
-                "welcomeWord", "sleepWord", "waitWord", "roleWord",
-                "wakeupWord", "failWord", "voice", "botId", "apiToken"};
-            const char *int_keys[] = {
-                "emotion", "language", "speed", "tone", "model"};
-
             // 获取字符串类型的配置
             for (const char *key : string_keys)
             {
-                std::string value = custom_settings.GetString(key, "");
-                cJSON_AddStringToObject(custom_config, key, value.c_str());
-                ESP_LOGI(TAG, "Read custom string setting: %s = %s", key, value.c_str());
+                writer.AddString(key, custom_settings.GetString(key, ""));
             }
-
             // 获取整数类型的配置
             for (const char *key : int_keys)
             {
-                int value = custom_settings.GetInt(key, 0);
-                cJSON_AddNumberToObject(custom_config, key, value);
-                ESP_LOGI(TAG, "Read custom int setting: %s = %d", key, value);
+                writer.AddInt(key, custom_settings.GetInt(key, 0));
             }
+            writer.EndObject();
 
-            // 将 custom_config 添加到 config 对象中
-            cJSON_AddItemToObject(config, "custom", custom_config);
-        }
-
-        // 添加配置对象到响应
-        cJSON_AddItemToObject(response, "config", config);
+            writer.EndObject();
+            writer.EndObject(); });
 
-        // 转换为字符串并发送
-        char *json_str = cJSON_PrintUnformatted(response);
-        if (json_str)
+        cJSON_Delete(root);
+        if (response.empty())
         {
-            ESP_LOGI(TAG, "Sending config response: %s", json_str);
-            esp_err_t ret = SendWebSocketMessage(sock, json_str, strlen(json_str));
-            free(json_str);
-            cJSON_Delete(response);
-            cJSON_Delete(root);
-            return ret;
+            ESP_LOGE(TAG, "Failed to build config response");
+            return ESP_FAIL;
         }
-
-        ESP_LOGE(TAG, "Failed to convert response to string");
-        cJSON_Delete(response);
+        ESP_LOGI(TAG, "Sending config response: %s", response.c_str());
+        return SendWebSocketMessage(sock, response.c_str(), response.size());
     }
     else if (strcmp(type->valuestring, "set_config") == 0)
     {
@@ -679,180 +651,118 @@ static esp_err_t HandleJsonMessage(int sock, const char *message)
         }
 
         // 发送成功响应
-        cJSON *response = cJSON_CreateObject();
-        if (response)
-        {
-            cJSON_AddStringToObject(response, "type", "set_config_response");
-            cJSON_AddBoolToObject(response, "success", true);
-
-            char *json_str = cJSON_PrintUnformatted(response);
-            if (json_str)
-            {
-                esp_err_t ret = SendWebSocketMessage(sock, json_str, strlen(json_str));
-                free(json_str);
-                cJSON_Delete(response);
-                cJSON_Delete(root);
-                return ret;
-            }
-            cJSON_Delete(response);
-        }
+        StaticJsonWriter<64> writer;
+        writer.BeginObject()
+            .AddString("type", "set_config_response")
+            .AddBool("success", true)
+            .EndObject();
+        cJSON_Delete(root);
+        return SendJsonMessage(sock, writer);
     }
     else if (strcmp(type->valuestring, "get_custom_config") == 0)
     {
         // 添加获取自定义配置的处理
         Settings custom_settings("custom");
 
-        // 创建响应
-        cJSON *response = cJSON_CreateObject();
-        if (!response)
-        {
-            ESP_LOGE(TAG, "Failed to create response object");
-            cJSON_Delete(root);
-            return ESP_FAIL;
-        }
+        std::string response = HeapJsonWriter::Write(512, [&custom_settings](JsonWriter &writer)
+                                                      {
+            writer.BeginObject().AddString("type", "get_custom_config");
+            writer.Key("config").BeginObject();
 
-        cJSON_AddStringToObject(response, "type", "get_custom_config");
-
-        // 添加所有自定义配置项
-        cJSON *config = cJSON_CreateObject();
-        if (!config)
-        {
-            ESP_LOGE(TAG, "Failed to create config object");
-            cJSON_Delete(response);
-            cJSON_Delete(root);
-            return ESP_FAIL;
-        }
-
-        // 获取实际设备音量
-        auto codec = Board::GetInstance().GetAudioCodec();
-        if (codec)
-        {
-            try
-            {
-                int current_volume = codec->output_volume();
-                cJSON_AddNumberToObject(config, "volume", current_volume);
-                ESP_LOGI(TAG, "Current device volume: %d", current_volume);
-            }
-            catch (const std::exception &e)
+            // 获取实际设备音量
+            auto codec = Board::GetInstance().GetAudioCodec();
+            if (codec)
             {
-                ESP_LOGW(TAG, "Failed to get device volume: %s", e.what());
-                // 如果获取失败，尝试从配置中读取
-                int saved_volume = custom_settings.GetInt("volume", 50);
-                cJSON_AddNumberToObject(config, "volume", saved_volume);
+                writer.AddInt("volume", codec->output_volume());
             }
-        }
 
-        // 动态获取所有自定义配置
-        std::vector<std::string> keys = custom_settings.GetAllKeys();
-        for (const auto &key : keys)
-        {
-            // 跳过 volume，因为我们已经从设备读取了实际值
-            if (key == "volume")
-                continue;
-
-            if (custom_settings.Contains(key))
+            // 动态获取所有自定义配置
+            std::vector<std::string> keys = custom_settings.GetAllKeys();
+            for (const auto &key : keys)
             {
+                // 跳过 volume，因为我们已经从设备读取了实际值
+                if (key == "volume")
+                    continue;
+
                 if (custom_settings.IsString(key))
                 {
-                    cJSON_AddStringToObject(config, key.c_str(), custom_settings.GetString(key, "").c_str());
+                    writer.Key(key).String(custom_settings.GetString(key, ""));
                 }
                 else if (custom_settings.IsInt(key))
                 {
-                    cJSON_AddNumberToObject(config, key.c_str(), custom_settings.GetInt(key, 0));
+                    writer.Key(key).Int(custom_settings.GetInt(key, 0));
                 }
                 else if (custom_settings.IsBool(key))
                 {
-                    cJSON_AddBoolToObject(config, key.c_str(), custom_settings.GetBool(key, false));
+                    writer.Key(key).Bool(custom_settings.GetBool(key, false));
                 }
             }
-        }
 
-        // 添加自定义配置到响应
-        cJSON_AddItemToObject(response, "config", config);
+            writer.EndObject();
+            writer.EndObject(); });
 
-        // 转换为字符串并发送
-        char *json_str = cJSON_PrintUnformatted(response);
-        if (json_str)
+        cJSON_Delete(root);
+        if (response.empty())
         {
-            ESP_LOGI(TAG, "Sending custom config response: %s", json_str);
-            esp_err_t ret = SendWebSocketMessage(sock, json_str, strlen(json_str));
-            free(json_str);
-            cJSON_Delete(response);
-            cJSON_Delete(root);
-            return ret;
+            ESP_LOGE(TAG, "Failed to build custom config response");
+            return ESP_FAIL;
         }
-
-        ESP_LOGE(TAG, "Failed to convert response to string");
-        cJSON_Delete(response);
+        ESP_LOGI(TAG, "Sending custom config response: %s", response.c_str());
+        return SendWebSocketMessage(sock, response.c_str(), response.size());
     }
     else if (strcmp(type->valuestring, "ping") == 0)
     {
         // 处理 JSON 格式的 ping
-        cJSON *response = cJSON_CreateObject();
-        if (response)
-        {
-            cJSON_AddStringToObject(response, "type", "pong");
-            char *json_str = cJSON_PrintUnformatted(response);
-            if (json_str)
-            {
-                esp_err_t ret = SendWebSocketMessage(sock, json_str, strlen(json_str));
-                free(json_str);
-                cJSON_Delete(response);
-                cJSON_Delete(root);
-                return ret;
-            }
-            cJSON_Delete(response);
-        }
+        StaticJsonWriter<32> writer;
+        writer.BeginObject().AddString("type", "pong").EndObject();
+        cJSON_Delete(root);
+        return SendJsonMessage(sock, writer);
+    }
+    else if (strcmp(type->valuestring, "get_trace") == 0)
+    {
+        // 导出延迟追踪数据，可直接在 chrome://tracing 或 Perfetto 中打开
+        std::string trace = LatencyTracer::GetInstance().ExportChromeTrace();
+        cJSON_Delete(root);
+        return SendWebSocketMessage(sock, trace.c_str(), trace.size());
     }
     else if (strcmp(type->valuestring, "reboot") == 0)
     {
         // 创建响应
-        cJSON *response = cJSON_CreateObject();
-        if (response)
-        {
-            cJSON_AddStringToObject(response, "type", "reboot_response");
-            cJSON_AddBoolToObject(response, "success", true);
+        StaticJsonWriter<64> writer;
+        writer.BeginObject()
+            .AddString("type", "reboot_response")
+            .AddBool("success", true)
+            .EndObject();
+        cJSON_Delete(root);
 
-            // 发送响应
-            char *json_str = cJSON_PrintUnformatted(response);
-            if (json_str)
-            {
-                // 发送响应并检查结果
-                if (SendWebSocketMessage(sock, json_str, strlen(json_str)) == ESP_OK)
-                {
-                    free(json_str);
-                    cJSON_Delete(response);
-                    cJSON_Delete(root);
-
-                    // 延迟一小段时间确保响应发送完成
-                    vTaskDelay(pdMS_TO_TICKS(500));
-
-                    // 创建一个独立的任务来执行重启
-                    xTaskCreate([](void *)
-                                {
-                        // 停止 WebSocket 服务器
-                        LocalWebsocketServer::GetInstance().Stop();
-                        
-                        // 停止 WiFi
-                        WifiStation::GetInstance().Stop();
-                        
-                        // 延迟以确保所有资源都被正确释放
-                        vTaskDelay(pdMS_TO_TICKS(1000));
-                        
-                        // 重启设备
-                        esp_restart();
-                        
-                        vTaskDelete(NULL); },
-                                "reboot_task", 4096, nullptr, 5, nullptr);
-
-                    return ESP_OK;
-                }
-                free(json_str);
-            }
-            cJSON_Delete(response);
+        // 发送响应并检查结果
+        if (SendJsonMessage(sock, writer) != ESP_OK)
+        {
+            return ESP_FAIL;
         }
-        cJSON_Delete(root);
-        return ESP_FAIL;
+
+        // 延迟一小段时间确保响应发送完成
+        vTaskDelay(pdMS_TO_TICKS(500));
+
+        // 创建一个独立的任务来执行重启
+        xTaskCreate([](void *)
+                    {
+            // 停止 WebSocket 服务器
+            LocalWebsocketServer::GetInstance().Stop();
+            
+            // 停止 WiFi
+            WifiStation::GetInstance().Stop();
+            
+            // 延迟以确保所有资源都被正确释放
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            
+            // 重启设备
+            esp_restart();
+            
+            vTaskDelete(NULL); },
+                    "reboot_task", 4096, nullptr, 5, nullptr);
+
+        return ESP_OK;
     }
     else
     {
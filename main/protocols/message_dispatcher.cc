@@ -0,0 +1,111 @@
+#include "message_dispatcher.h"
+
+#include <esp_log.h>
+#include <cstring>
+
+#define TAG "MessageDispatcher"
+
+void MessageDispatcher::Register(const char* type, MessageHandler handler) {
+    Register(Entry{type, nullptr, std::move(handler), nullptr});
+}
+
+void MessageDispatcher::Register(const char* type, const char* state, MessageHandler handler) {
+    Register(Entry{type, state, std::move(handler), nullptr});
+}
+
+void MessageDispatcher::RegisterJson(const char* type, JsonHandler handler) {
+    Register(Entry{type, nullptr, nullptr, std::move(handler)});
+}
+
+void MessageDispatcher::RegisterJson(const char* type, const char* state, JsonHandler handler) {
+    Register(Entry{type, state, nullptr, std::move(handler)});
+}
+
+void MessageDispatcher::Register(Entry&& entry) {
+    auto type = entry.type;
+    auto state = entry.state;
+    auto key = MessageKey(type, state);
+    auto it = handlers_.find(key);
+    if (it != handlers_.end()) {
+        // 不同的名称哈希冲突时无法共存，需要修改消息类型
+        if (strcmp(it->second.type, type) != 0 ||
+            (it->second.state == nullptr) != (state == nullptr) ||
+            (state != nullptr && strcmp(it->second.state, state) != 0)) {
+            ESP_LOGE(TAG, "Hash collision: %s/%s and %s/%s", it->second.type,
+                it->second.state ? it->second.state : "", type, state ? state : "");
+            return;
+        }
+        ESP_LOGW(TAG, "Handler for %s/%s replaced", type, state ? state : "");
+    }
+    // type 和 state 必须是静态字符串，这里只保存指针
+    handlers_[key] = std::move(entry);
+}
+
+const MessageDispatcher::Entry* MessageDispatcher::Find(uint32_t key, const char* type, const char* state) const {
+    auto it = handlers_.find(key);
+    if (it == handlers_.end()) {
+        return nullptr;
+    }
+    // 命中后再比较一次字符串，避免未注册的消息因哈希冲突被误分发
+    auto& entry = it->second;
+    if (strcmp(entry.type, type) != 0) {
+        return nullptr;
+    }
+    if (entry.state != nullptr && (state == nullptr || strcmp(entry.state, state) != 0)) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+const MessageDispatcher::Entry* MessageDispatcher::Find(const char* type, const char* state) const {
+    uint32_t type_hash = FnvHash(type);
+    const Entry* entry = nullptr;
+    if (state != nullptr) {
+        uint32_t key = FnvHash(state, FnvHash('.', type_hash));
+        entry = Find(key, type, state);
+    }
+    if (entry == nullptr) {
+        entry = Find(type_hash, type, nullptr);
+    }
+    return entry;
+}
+
+DispatchResult MessageDispatcher::Dispatch(const IncomingMessage& message) {
+    if (message.type == nullptr) {
+        ESP_LOGE(TAG, "Missing message type");
+        return kDispatchUnhandled;
+    }
+    auto entry = Find(message.type, message.state);
+    if (entry == nullptr) {
+        return kDispatchUnhandled;
+    }
+    if (entry->json_handler) {
+        return kDispatchNeedsJson;
+    }
+    entry->message_handler(message);
+    return kDispatchHandled;
+}
+
+bool MessageDispatcher::Dispatch(const cJSON* root) {
+    IncomingMessage message;
+    message.type = cJSON_GetStringValue(cJSON_GetObjectItem(root, "type"));
+    if (message.type == nullptr) {
+        ESP_LOGE(TAG, "Missing message type");
+        return false;
+    }
+    message.state = cJSON_GetStringValue(cJSON_GetObjectItem(root, "state"));
+
+    auto entry = Find(message.type, message.state);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->json_handler) {
+        entry->json_handler(root);
+        return true;
+    }
+    message.text = cJSON_GetStringValue(cJSON_GetObjectItem(root, "text"));
+    message.emotion = cJSON_GetStringValue(cJSON_GetObjectItem(root, "emotion"));
+    message.session_id = cJSON_GetStringValue(cJSON_GetObjectItem(root, "session_id"));
+    entry->message_handler(message);
+    return true;
+}
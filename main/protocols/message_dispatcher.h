@@ -0,0 +1,64 @@
+#ifndef MESSAGE_DISPATCHER_H
+#define MESSAGE_DISPATCHER_H
+
+#include <cJSON.h>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "fnv_hash.h"
+
+// type 与 state 组合的键，state 为空时只按 type 匹配
+constexpr uint32_t MessageKey(const char* type, const char* state = nullptr) {
+    return state == nullptr ? FnvHash(type) : FnvHash(state, FnvHash('.', FnvHash(type)));
+}
+
+// 控制消息中常用的顶层字符串字段，不存在的字段为 nullptr
+// 轻量解析时指针指向协议的解析缓冲区，只在处理函数执行期间有效
+struct IncomingMessage {
+    const char* type = nullptr;
+    const char* state = nullptr;
+    const char* text = nullptr;
+    const char* emotion = nullptr;
+    const char* session_id = nullptr;
+};
+
+enum DispatchResult {
+    kDispatchHandled,
+    kDispatchNeedsJson,     // 处理函数需要完整的 cJSON 树
+    kDispatchUnhandled
+};
+
+// 按消息的 type（以及可选的 state）字段分发 JSON 消息
+// 先查找 type + state 的处理函数，找不到时再查找只注册了 type 的处理函数
+// 只读取常用字段的处理函数直接使用 IncomingMessage，需要嵌套字段的（如 iot 命令）注册为 JsonHandler
+class MessageDispatcher {
+public:
+    using MessageHandler = std::function<void(const IncomingMessage& message)>;
+    using JsonHandler = std::function<void(const cJSON* root)>;
+
+    void Register(const char* type, MessageHandler handler);
+    void Register(const char* type, const char* state, MessageHandler handler);
+    void RegisterJson(const char* type, JsonHandler handler);
+    void RegisterJson(const char* type, const char* state, JsonHandler handler);
+
+    // 按轻量解析的结果分发，匹配到 JsonHandler 时返回 kDispatchNeedsJson，由调用者用 cJSON 解析后重新分发
+    DispatchResult Dispatch(const IncomingMessage& message);
+    // 返回 false 表示没有匹配的处理函数
+    bool Dispatch(const cJSON* root);
+
+private:
+    struct Entry {
+        const char* type;
+        const char* state;
+        MessageHandler message_handler;
+        JsonHandler json_handler;
+    };
+    std::unordered_map<uint32_t, Entry> handlers_;
+
+    void Register(Entry&& entry);
+    const Entry* Find(const char* type, const char* state) const;
+    const Entry* Find(uint32_t key, const char* type, const char* state) const;
+};
+
+#endif // MESSAGE_DISPATCHER_H
@@ -14,6 +14,16 @@
 
 MqttProtocol::MqttProtocol() {
     event_group_handle_ = xEventGroupCreate();
+    dispatcher_.RegisterJson("hello", [this](const cJSON* root) {
+        ParseServerHello(root);
+    });
+    dispatcher_.Register("goodbye", [this](const IncomingMessage& message) {
+        if (message.session_id == nullptr || session_id_ == message.session_id) {
+            Application::GetInstance().Schedule([this]() {
+                CloseAudioChannel();
+            });
+        }
+    });
 }
 
 MqttProtocol::~MqttProtocol() {
@@ -60,31 +70,7 @@ bool MqttProtocol::StartMqttClient() {
     });
 
     mqtt_->OnMessage([this](const std::string& topic, const std::string& payload) {
-        cJSON* root = cJSON_Parse(payload.c_str());
-        if (root == nullptr) {
-            ESP_LOGE(TAG, "Failed to parse json message %s", payload.c_str());
-            return;
-        }
-        cJSON* type = cJSON_GetObjectItem(root, "type");
-        if (type == nullptr) {
-            ESP_LOGE(TAG, "Message type is not specified");
-            cJSON_Delete(root);
-            return;
-        }
-
-        if (strcmp(type->valuestring, "hello") == 0) {
-            ParseServerHello(root);
-        } else if (strcmp(type->valuestring, "goodbye") == 0) {
-            auto session_id = cJSON_GetObjectItem(root, "session_id");
-            if (session_id == nullptr || session_id_ == session_id->valuestring) {
-                Application::GetInstance().Schedule([this]() {
-                    CloseAudioChannel();
-                });
-            }
-        } else if (on_incoming_json_ != nullptr) {
-            on_incoming_json_(root);
-        }
-        cJSON_Delete(root);
+        HandleIncomingText(payload.data(), payload.size());
     });
 
     ESP_LOGI(TAG, "Connecting to endpoint %s", endpoint_.c_str());
@@ -145,11 +131,12 @@ void MqttProtocol::CloseAudioChannel() {
         }
     }
 
-    std::string message = "{";
-    message += "\"session_id\":\"" + session_id_ + "\",";
-    message += "\"type\":\"goodbye\"";
-    message += "}";
-    SendText(message);
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [this](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "goodbye")
+            .EndObject();
+    });
 
     if (on_audio_channel_closed_ != nullptr) {
         on_audio_channel_closed_();
@@ -168,14 +155,19 @@ bool MqttProtocol::OpenAudioChannel() {
     xEventGroupClearBits(event_group_handle_, MQTT_PROTOCOL_SERVER_HELLO_EVENT);
 
     // 发送 hello 消息申请 UDP 通道
-    std::string message = "{";
-    message += "\"type\":\"hello\",";
-    message += "\"version\": 3,";
-    message += "\"transport\":\"udp\",";
-    message += "\"audio_params\":{";
-    message += "\"format\":\"opus\", \"sample_rate\":16000, \"channels\":1, \"frame_duration\":" + std::to_string(OPUS_FRAME_DURATION_MS);
-    message += "}}";
-    SendText(message);
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("type", "hello")
+            .AddInt("version", 3)
+            .AddString("transport", "udp");
+        writer.Key("audio_params").BeginObject()
+            .AddString("format", "opus")
+            .AddInt("sample_rate", 16000)
+            .AddInt("channels", 1)
+            .AddInt("frame_duration", OPUS_FRAME_DURATION_MS)
+            .EndObject();
+        writer.EndObject();
+    });
 
     // 等待服务器响应
     EventBits_t bits = xEventGroupWaitBits(event_group_handle_, MQTT_PROTOCOL_SERVER_HELLO_EVENT, pdTRUE, pdFALSE, pdMS_TO_TICKS(10000));
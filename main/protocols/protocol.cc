@@ -1,6 +1,9 @@
 #include "protocol.h"
 
 #include <esp_log.h>
+#include <cstring>
+
+#include "json_reader.h"
 
 #define TAG "Protocol"
 
@@ -8,6 +11,56 @@ void Protocol::OnIncomingJson(std::function<void(const cJSON* root)> callback) {
     on_incoming_json_ = callback;
 }
 
+void Protocol::OnIncomingJson(const char* type, std::function<void(const cJSON* root)> callback) {
+    dispatcher_.RegisterJson(type, callback);
+}
+
+void Protocol::OnIncomingJson(const char* type, const char* state, std::function<void(const cJSON* root)> callback) {
+    dispatcher_.RegisterJson(type, state, callback);
+}
+
+void Protocol::OnIncomingMessage(const char* type, std::function<void(const IncomingMessage& message)> callback) {
+    dispatcher_.Register(type, callback);
+}
+
+void Protocol::OnIncomingMessage(const char* type, const char* state, std::function<void(const IncomingMessage& message)> callback) {
+    dispatcher_.Register(type, state, callback);
+}
+
+void Protocol::HandleIncomingText(const char* data, size_t length) {
+    static const char* const FIELD_NAMES[] = { "type", "state", "text", "emotion", "session_id" };
+
+    // 大部分控制消息只需要几个顶层字符串字段，复制到预分配的缓冲区原地解析
+    if (length < sizeof(parse_buffer_)) {
+        memcpy(parse_buffer_, data, length);
+        parse_buffer_[length] = '\0';
+        const char* values[5];
+        if (JsonReader::ParseStringFields(parse_buffer_, length, FIELD_NAMES, values, 5)) {
+            IncomingMessage message;
+            message.type = values[0];
+            message.state = values[1];
+            message.text = values[2];
+            message.emotion = values[3];
+            message.session_id = values[4];
+            auto result = dispatcher_.Dispatch(message);
+            if (result == kDispatchHandled || (result == kDispatchUnhandled && on_incoming_json_ == nullptr)) {
+                return;
+            }
+        }
+    }
+
+    // 需要嵌套字段、消息过长或轻量解析失败时回退到 cJSON
+    auto root = cJSON_ParseWithLength(data, length);
+    if (root == nullptr) {
+        ESP_LOGE(TAG, "Failed to parse json message %.*s", (int)length, data);
+        return;
+    }
+    if (!dispatcher_.Dispatch(root) && on_incoming_json_ != nullptr) {
+        on_incoming_json_(root);
+    }
+    cJSON_Delete(root);
+}
+
 void Protocol::OnIncomingAudio(std::function<void(std::vector<uint8_t>&& data)> callback) {
     on_incoming_audio_ = callback;
 }
@@ -24,47 +77,90 @@ void Protocol::OnNetworkError(std::function<void(const std::string& message)> ca
     on_network_error_ = callback;
 }
 
-void Protocol::SendAbortSpeaking(AbortReason reason) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"abort\"";
-    if (reason == kAbortReasonWakeWordDetected) {
-        message += ",\"reason\":\"wake_word_detected\"";
+void Protocol::SendJson(size_t capacity, const std::function<void(JsonWriter& writer)>& write) {
+    if (capacity <= PROTOCOL_JSON_STACK_SIZE) {
+        StaticJsonWriter<PROTOCOL_JSON_STACK_SIZE> writer;
+        write(writer);
+        if (writer.ok()) {
+            SendText(writer.ToString());
+            return;
+        }
+        capacity = PROTOCOL_JSON_STACK_SIZE * 2;
+    }
+    std::string json = HeapJsonWriter::Write(capacity, write);
+    if (json.empty()) {
+        ESP_LOGE(TAG, "Failed to build JSON message");
+        return;
     }
-    message += "}";
-    SendText(message);
+    SendText(json);
+}
+
+void Protocol::SendAbortSpeaking(AbortReason reason) {
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [this, reason](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "abort");
+        if (reason == kAbortReasonWakeWordDetected) {
+            writer.AddString("reason", "wake_word_detected");
+        }
+        writer.EndObject();
+    });
 }
 
 void Protocol::SendWakeWordDetected(const std::string& wake_word) {
-    std::string json = "{\"session_id\":\"" + session_id_ + 
-                      "\",\"type\":\"listen\",\"state\":\"detect\",\"text\":\"" + wake_word + "\"}";
-    SendText(json);
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [this, &wake_word](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "listen")
+            .AddString("state", "detect")
+            .AddString("text", wake_word)
+            .EndObject();
+    });
 }
 
 void Protocol::SendStartListening(ListeningMode mode) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\"";
-    message += ",\"type\":\"listen\",\"state\":\"start\"";
-    if (mode == kListeningModeAlwaysOn) {
-        message += ",\"mode\":\"realtime\"";
-    } else if (mode == kListeningModeAutoStop) {
-        message += ",\"mode\":\"auto\"";
-    } else {
-        message += ",\"mode\":\"manual\"";
-    }
-    message += "}";
-    SendText(message);
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [this, mode](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "listen")
+            .AddString("state", "start");
+        if (mode == kListeningModeAlwaysOn) {
+            writer.AddString("mode", "realtime");
+        } else if (mode == kListeningModeAutoStop) {
+            writer.AddString("mode", "auto");
+        } else {
+            writer.AddString("mode", "manual");
+        }
+        writer.EndObject();
+    });
 }
 
 void Protocol::SendStopListening() {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"listen\",\"state\":\"stop\"}";
-    SendText(message);
+    SendJson(PROTOCOL_JSON_STACK_SIZE, [this](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "listen")
+            .AddString("state", "stop")
+            .EndObject();
+    });
 }
 
 void Protocol::SendIotDescriptors(const std::string& descriptors) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"iot\",\"descriptors\":" + descriptors + "}";
-    SendText(message);
+    SendJson(descriptors.size() + session_id_.size() + 96, [this, &descriptors](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "iot")
+            .AddRaw("descriptors", descriptors)
+            .EndObject();
+    });
 }
 
 void Protocol::SendIotStates(const std::string& states) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"iot\",\"states\":" + states + "}";
-    SendText(message);
+    SendJson(states.size() + session_id_.size() + 96, [this, &states](JsonWriter& writer) {
+        writer.BeginObject()
+            .AddString("session_id", session_id_)
+            .AddString("type", "iot")
+            .AddRaw("states", states)
+            .EndObject();
+    });
 }
-
@@ -3,8 +3,17 @@
 
 #include <cJSON.h>
 #include <string>
+#include <vector>
 #include <functional>
 
+#include "message_dispatcher.h"
+#include "json_writer.h"
+
+// 轻量解析入站文本消息的缓冲区大小，超过此长度的消息回退到 cJSON
+#define PROTOCOL_PARSE_BUFFER_SIZE 1024
+// 短小控制消息在栈上生成的缓冲区大小
+#define PROTOCOL_JSON_STACK_SIZE 256
+
 struct BinaryProtocol3 {
     uint8_t type;
     uint8_t reserved;
@@ -35,7 +44,14 @@ public:
     }
 
     void OnIncomingAudio(std::function<void(std::vector<uint8_t>&& data)> callback);
+    // 没有注册处理函数的消息交给这个回调
     void OnIncomingJson(std::function<void(const cJSON* root)> callback);
+    // 需要嵌套字段的消息，分发前用 cJSON 完整解析
+    void OnIncomingJson(const char* type, std::function<void(const cJSON* root)> callback);
+    void OnIncomingJson(const char* type, const char* state, std::function<void(const cJSON* root)> callback);
+    // 只读取常用字段的消息，不分配堆内存
+    void OnIncomingMessage(const char* type, std::function<void(const IncomingMessage& message)> callback);
+    void OnIncomingMessage(const char* type, const char* state, std::function<void(const IncomingMessage& message)> callback);
     void OnAudioChannelOpened(std::function<void()> callback);
     void OnAudioChannelClosed(std::function<void()> callback);
     void OnNetworkError(std::function<void(const std::string& message)> callback);
@@ -61,8 +77,15 @@ protected:
 
     int server_sample_rate_ = 16000;
     std::string session_id_;
+    MessageDispatcher dispatcher_;
+    char parse_buffer_[PROTOCOL_PARSE_BUFFER_SIZE];
 
     virtual void SendText(const std::string& text) = 0;
+    // 生成并发送 JSON 消息，先写入 capacity 大小的缓冲区（不超过 PROTOCOL_JSON_STACK_SIZE 时在栈上），
+    // 不足时在堆上加倍容量重新生成，消息不会因为 session_id 等字段过长而被丢弃
+    void SendJson(size_t capacity, const std::function<void(JsonWriter& writer)>& write);
+    // 处理一条服务器文本消息，data 不要求以 '\0' 结尾
+    void HandleIncomingText(const char* data, size_t length);
 };
 
 #endif // PROTOCOL_H
@@ -0,0 +1,76 @@
+# pack animated emotion frames into the "emotions" data partition image
+#
+# Input directory layout, one sub directory per emotion (names as sent by the server):
+#   <input_dir>/happy/0.png, 1.png, ...
+#   <input_dir>/happy/interval.txt   (optional, frame interval in ms, default 100)
+# Emotions without a directory keep using the font emoji on the device.
+#
+# Flash with: esptool.py write_flash 0xD00000 emotions.bin
+import os
+import struct
+import sys
+from PIL import Image
+
+# Must match EmotionId in main/display/emotions.h
+EMOTIONS = [
+    "neutral", "happy", "laughing", "funny", "sad", "angry", "crying",
+    "loving", "embarrassed", "surprised", "shocked", "thinking", "winking",
+    "cool", "relaxed", "delicious", "kissy", "confident", "sleepy", "silly",
+    "confused",
+]
+
+MAGIC = 0x534f4d45  # "EMOS"
+VERSION = 1
+HEADER_FORMAT = '<IHHHHI'
+ENTRY_FORMAT = '<IHH'
+
+
+def load_frames(emotion_dir, size):
+    files = sorted((f for f in os.listdir(emotion_dir) if f.endswith('.png')),
+                   key=lambda f: int(os.path.splitext(f)[0]))
+    return [Image.open(os.path.join(emotion_dir, f)).convert('RGBA').resize(size) for f in files]
+
+
+def encode_rgb565a8(image):
+    # LV_COLOR_FORMAT_RGB565A8: little endian RGB565 plane followed by the alpha plane
+    rgb = bytearray()
+    alpha = bytearray()
+    for r, g, b, a in image.getdata():
+        rgb += struct.pack('<H', ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+        alpha.append(a)
+    return bytes(rgb + alpha)
+
+
+def pack(input_dir, output_file, width, height):
+    entries = []
+    frames = bytearray()
+    data_offset = struct.calcsize(HEADER_FORMAT) + struct.calcsize(ENTRY_FORMAT) * len(EMOTIONS)
+    for name in EMOTIONS:
+        emotion_dir = os.path.join(input_dir, name)
+        if not os.path.isdir(emotion_dir):
+            entries.append((0, 0, 0))
+            continue
+        interval = 100
+        interval_file = os.path.join(emotion_dir, 'interval.txt')
+        if os.path.exists(interval_file):
+            with open(interval_file) as f:
+                interval = int(f.read().strip())
+        images = load_frames(emotion_dir, (width, height))
+        entries.append((data_offset + len(frames), len(images), interval))
+        for image in images:
+            frames += encode_rgb565a8(image)
+        print(f'{name}: {len(images)} frames, {interval} ms')
+
+    with open(output_file, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(EMOTIONS), width, height, 0))
+        for entry in entries:
+            f.write(struct.pack(ENTRY_FORMAT, *entry))
+        f.write(frames)
+    print(f'Total size: {data_offset + len(frames)} bytes')
+
+
+if len(sys.argv) != 5:
+    print('Usage: python pack_emotion_sprites.py <input_dir> <output_file> <width> <height>')
+    sys.exit(1)
+
+pack(sys.argv[1], sys.argv[2], int(sys.argv[3]), int(sys.argv[4]))
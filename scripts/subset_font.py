@@ -0,0 +1,72 @@
+# generate a font subset of the most frequent characters in a text corpus with lv_font_conv
+#
+# Glyphs are selected by frequency, but lv_font_conv always emits them sorted by
+# codepoint, so the order of --symbols does not affect the layout in flash.
+#
+# Usage: python subset_font.py <font.ttf> <size> <bpp> <max_glyphs> <output.c> <corpus files...>
+# Requires: npm install -g lv_font_conv
+import collections
+import re
+import subprocess
+import sys
+
+# Always keep printable ASCII and common Chinese punctuation
+BASE_SYMBOLS = ''.join(chr(c) for c in range(0x20, 0x7F)) + '，。！？、：；“”‘’（）《》…—'
+
+
+def count_chars(files):
+    counter = collections.Counter()
+    for file in files:
+        with open(file, encoding='utf-8') as f:
+            for ch in f.read():
+                if ch.isprintable() and not ch.isspace():
+                    counter[ch] += 1
+    return counter
+
+
+def subset(font_file, size, bpp, max_glyphs, output_file, corpus_files):
+    counter = count_chars(corpus_files)
+    symbols = list(BASE_SYMBOLS)
+    for ch, _ in counter.most_common():
+        if len(symbols) >= max_glyphs:
+            break
+        if ch not in symbols:
+            symbols.append(ch)
+
+    total = sum(counter.values())
+    covered = sum(counter[ch] for ch in symbols)
+    print(f'{len(symbols)} glyphs cover {covered * 100 / max(total, 1):.2f}% of {total} corpus characters')
+
+    name = output_file.rsplit('/', 1)[-1].rsplit('.', 1)[0]
+    command = [
+        'lv_font_conv', '--no-compress', '--no-prefilter',
+        '--font', font_file, '--size', str(size), '--bpp', str(bpp),
+        '--format', 'lvgl', '--lv-font-name', name,
+        '--symbols', ''.join(symbols), '-o', output_file,
+    ]
+    subprocess.run(command, check=True)
+    bitmap_bytes, glyph_count = measure(output_file)
+    # lv_font_fmt_txt_glyph_dsc_t is 8 bytes per glyph
+    print(f'Generated {output_file}: {glyph_count} glyphs, {bitmap_bytes} bytes of bitmap, '
+          f'{bitmap_bytes + glyph_count * 8} bytes of bitmap and descriptors in flash')
+
+
+def measure(output_file):
+    """Return the glyph bitmap size in bytes and the glyph count of an lv_font_conv C file"""
+    with open(output_file, encoding='utf-8') as f:
+        source = f.read()
+    bitmap = re.search(r'glyph_bitmap\[\]\s*=\s*\{(.*?)\};', source, re.S)
+    descriptors = re.search(r'glyph_dsc\[\]\s*=\s*\{(.*?)\};', source, re.S)
+    if bitmap is None or descriptors is None:
+        sys.exit(f'{output_file} does not look like lv_font_conv output')
+    bitmap_bytes = len(re.findall(r'0x[0-9a-fA-F]{2}', re.sub(r'/\*.*?\*/', '', bitmap.group(1), flags=re.S)))
+    # The first descriptor is a reserved entry, not a glyph
+    glyph_count = descriptors.group(1).count('.bitmap_index') - 1
+    return bitmap_bytes, glyph_count
+
+
+if len(sys.argv) < 7:
+    print('Usage: python subset_font.py <font.ttf> <size> <bpp> <max_glyphs> <output.c> <corpus files...>')
+    sys.exit(1)
+
+subset(sys.argv[1], int(sys.argv[2]), int(sys.argv[3]), int(sys.argv[4]), sys.argv[5], sys.argv[6:])